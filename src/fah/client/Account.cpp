@@ -31,6 +31,7 @@
 #include "NodeRemote.h"
 #include "Config.h"
 #include "Groups.h"
+#include "Batch.h"
 
 #include <cbang/Catch.h>
 #include <cbang/json/Reader.h>
@@ -42,6 +43,7 @@
 #include <cbang/util/Random.h>
 #include <cbang/util/WeakCallback.h>
 #include <cbang/comp/Press.h>
+#include <cbang/time/Timer.h>
 #include <cbang/os/SystemInfo.h>
 #include <cbang/http/Conn.h>
 #include <cbang/config/RegexConstraint.h>
@@ -66,6 +68,9 @@ Account::Account(App &app) : app(app) {
   options.add("account-token", "Folding@home account token.");
   options.add("machine-name", "Name used to identify this machine.",
     new RegexConstraint(Regex(machNameRE), machNameHelp));
+  options.add("compression-threshold", "Compress encrypted messages to the "
+              "account node larger than this many bytes."
+              )->setDefault(10000);
   options.popCategory();
 
   setMaxMessageSize(maxInputSize);
@@ -93,6 +98,8 @@ void Account::init() {
 
   // Command line linking
   auto &options = app.getOptions();
+  compressionThreshold = options["compression-threshold"].toInteger();
+
   if (options["account-token"].hasValue()) {
     string token = options["account-token"];
 
@@ -146,19 +153,44 @@ void Account::restart() {
 }
 
 
-void Account::sendEncrypted(const JSON::Value &_msg, const string &sid) {
+string Account::negotiateCompression(const JSON::Value &codecs) {
+  // In the session's order of preference.  zstd is not available in Press.
+  for (unsigned i = 0; i < codecs.size(); i++) {
+    string codec = codecs.getString(i);
+    if (codec == "lz4" || codec == "gzip" || codec == "none") return codec;
+  }
+
+  return "none";
+}
+
+
+void Account::sendEncrypted(const JSON::Value &_msg, const string &sid,
+                            compression_t *compression) {
   string payload = _msg.toString(0, false);
   string iv = Random::instance().string(ivSize);
   Cipher cipher("aes-256-cbc", true, sessionKey.data(), iv.data());
   JSON::Dict msg;
+  string codec = compression ? compression->codec : "gzip";
+
+  if (compression) {
+    compression->messages++;
+    compression->bytesIn += payload.length();
+  }
 
-  ivs.insert(iv); // Prevent IV reuse and message replay
+  if (codec != "none" && compressionThreshold < payload.length()) {
+    double start = Timer::now();
 
-  if (10000 < payload.length()) {
-    msg.insert("compression", "gzip");
-    payload = Press("gzip").compress(payload);
+    msg.insert("compression", codec);
+    payload = Press(codec).compress(payload);
+
+    if (compression) {
+      compression->compressed++;
+      compression->seconds += Timer::now() - start;
+    }
   }
 
+  if (compression) compression->bytesOut += payload.length();
+
   msg.insert("type",    "message");
   msg.insert("client",  app.getID());
   msg.insert("session", sid);
@@ -226,7 +258,10 @@ void Account::info() {
 
       } else { // Account is valid, connect to node
         setData(req.getInputJSON());
+
+        Batch batch(app);
         app.getConfig()->configure(*data);
+        batch.commit();
 
         auto db = app.getDB("config");
         db.set("account", data->toString());
@@ -322,15 +357,15 @@ void Account::onEncrypted(const JSON::ValuePtr &_msg) {
 
   if (iv.length() != ivSize) THROW("Invalid IV length " << iv.length());
 
-  // Check that this is a unique IV.  Also prevents replay attacks.
-  if (!ivs.insert(iv).second) THROW("IV cannot be used more than once");
-
-  // Reset connection to prevent memory overflow.
-  if (4e6 < ivs.size()) THROW("Too many IVs");
-
   Cipher cipher("aes-256-cbc", false, sessionKey.data(), iv.data());
   JSON::ValuePtr msg = JSON::Reader::parse(cipher.crypt(payload));
 
+  // The sequence number is encrypted with the message, so it cannot be
+  // changed to replay an old one
+  if (!msg->has("seq")) THROW("Encrypted message missing sequence number");
+  if (!replay.check(msg->getU64("seq")))
+    THROW("Encrypted message replayed or too old");
+
   LOG_DEBUG(5, *msg);
 
   string type = msg->getString("type");
@@ -340,8 +375,7 @@ void Account::onEncrypted(const JSON::ValuePtr &_msg) {
     auto it = nodes.find(sid);
     if (it == nodes.end()) THROW("Session " << sid << " does not exist");
 
-    auto remote = it->second;
-    remote->onMessage(msg->get("content"));
+    it->second->onMessage(msg->get("content"));
 
   } else if (type == "session-open") {
     // Close any session being replaced, it would never be removed otherwise
@@ -350,6 +384,11 @@ void Account::onEncrypted(const JSON::ValuePtr &_msg) {
 
     // Open the session
     auto remote = SmartPtr(new NodeRemote(app, *this, sid));
+    remote->setBatching(msg->getBoolean("batch", false));
+    if (msg->hasList("compression"))
+      remote->setCompression(negotiateCompression(*msg->get("compression")));
+    if (msg->has("since"))
+      remote->setResume(msg->getString("journal", ""), msg->getU64("since"));
     app.add(remote);
     remote->onOpen();
     nodes[sid] = remote;
@@ -395,7 +434,7 @@ void Account::onOpen() {
 
   // Generate encryption key
   sessionKey = Random::instance().string(32);
-  ivs.clear(); // Reset IVs
+  replay.clear(); // Sequence numbers restart with the key
 
   // Encrypt key with account public key using RSA-OAEP
   KeyContext kctx(accountKey);
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include "ReplayFilter.h"
+
 #include <cbang/event/Event.h>
 #include <cbang/ws/JSONWebsocket.h>
 #include <cbang/util/Backoff.h>
@@ -45,6 +47,18 @@ namespace FAH {
     class Account : public cb::WS::JSONWebsocket {
       App &app;
 
+    public:
+      struct compression_t {
+        std::string codec = "gzip";
+        uint64_t messages   = 0;
+        uint64_t compressed = 0;
+        uint64_t bytesIn    = 0; // Before compression
+        uint64_t bytesOut   = 0; // After compression
+        double   seconds    = 0; // Time spent compressing
+      };
+
+    private:
+
       typedef enum {
         STATE_IDLE,
         STATE_LINK,
@@ -65,7 +79,8 @@ namespace FAH {
       cb::SmartPointer<cb::Event::Event> updateEvent;
       cb::Backoff updateBackoff = cb::Backoff(15, 4 * 60);
 
-      std::set<std::string> ivs;
+      ReplayFilter replay;
+      unsigned compressionThreshold = 10000;
 
       typedef std::map<std::string, cb::SmartPointer<NodeRemote>> nodes_t;
       nodes_t nodes;
@@ -82,7 +97,9 @@ namespace FAH {
       void link(const std::string &token, const std::string &machName);
       void restart();
 
-      void sendEncrypted(const cb::JSON::Value &msg, const std::string &sid);
+      static std::string negotiateCompression(const cb::JSON::Value &codecs);
+      void sendEncrypted(const cb::JSON::Value &msg, const std::string &sid,
+                         compression_t *compression = 0);
 
     protected:
       void setState(state_t state);
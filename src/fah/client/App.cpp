@@ -31,12 +31,19 @@
 #include "Account.h"
 #include "GPUResources.h"
 #include "Groups.h"
+#include "Group.h"
 #include "Units.h"
+#include "Unit.h"
 #include "Cores.h"
 #include "Config.h"
 #include "OS.h"
 #include "Remote.h"
 #include "LogTracker.h"
+#include "LogStore.h"
+#include "Journal.h"
+#include "WorkerThread.h"
+#include "FileWatcher.h"
+#include "Batch.h"
 
 #include <cbang/Catch.h>
 #include <cbang/Info.h>
@@ -101,7 +108,10 @@ App::App() :
   Application("Folding@home Client"), base(true, 10),
   client(base, new SSLContext), server(new Server(*this)),
   account(new Account(*this)), gpus(new GPUResources(*this)),
-  cores(new Cores(*this)), logTracker(new LogTracker(base)) {
+  cores(new Cores(*this)), logTracker(new LogTracker(base)),
+  logStore(new LogStore(*this)),
+  journal(new Journal), worker(new WorkerThread(base)),
+  watcher(new FileWatcher(*this)) {
 
   saveEvent = base.newEvent([this] {saveGlobalConfig();}, 0);
 
@@ -134,6 +144,25 @@ App::App() :
   options.add("web-root", "Path to files to be served by the client's Web "
               "server")->setDefault("fah-web-control/dist");
   options.add("on-idle", "Folding only when idle.")->setDefault(false);
+  options.add("log-file", "Log file written by the client on its own "
+              "thread.  It is rotated on start and every ``log-rotate-period`` "
+              "in to ``log-rotate-dir``, keeping ``log-rotate-max`` files.  "
+              "Empty disables it, as does the older, synchronous, ``log``.  "
+              "Setting both is an error.")->setDefault("log.txt");
+  options.add("log-buffer-size", "Bytes of recent log lines kept in memory "
+              "for remotes.")->setDefault(1e7);
+  options.add("log-store-days", "Days of log lines kept in the indexed, "
+              "compressed log store which remotes can query.  Zero, the "
+              "default, disables the store.")->setDefault(0);
+  options.add("log-segment-size", "Bytes of log lines in each compressed log "
+              "store segment.")->setDefault(1 << 18);
+#ifndef _WIN32
+  options.add("local-socket", "Also accept Web and Websocket connections on "
+              "this Unix domain socket.  Origins are not checked, access is "
+              "controlled by the socket's file permissions.");
+  options.add("local-socket-mode", "Octal file permissions for "
+              "``local-socket``.")->setDefault("0660");
+#endif
   options.popCategory();
 
   // Note these options are available but hidden in non-debug builds
@@ -180,7 +209,6 @@ App::App() :
 
   // Configure log
   options["verbosity"         ].setDefault(3);
-  options["log"               ].setDefault("log.txt");
   options["log-no-info-header"].setDefault(true);
   options["log-thread-prefix" ].setDefault(true);
   options["log-short-level"   ].setDefault(true);
@@ -259,11 +287,50 @@ void App::configure(const JSON::Value &msg) {
 
   if (msg.hasDict("config")) {
     auto config = msg.get("config");
+    bool groups = config->hasDict("groups");
+
+    // Check everything before changing anything
+    if (groups) getGroups()->validate(*config->get("groups"));
+    getConfig()->validate(*config);
+
+    // Keep the current config in case applying fails
+    auto oldConfig = getConfig()->copy(true);
+    JSON::ValuePtr oldGroups = new JSON::Dict;
+    vector<pair<SmartPointer<Unit>, string> > oldUnitGroups;
+    if (groups) {
+      for (auto &name: getGroups()->keys()) {
+        auto &group = getGroups()->getGroup(name);
+        oldGroups->insert(name, group.getConfig().copy(true));
+      }
+
+      // Deleting a group moves its units to the default group
+      auto &units = *getUnits();
+      for (unsigned i = 0; i < units.size(); i++) {
+        auto unit = units.getUnit(i);
+        oldUnitGroups.push_back(make_pair(unit, unit->getGroup().getName()));
+      }
+    }
 
-    if (config->hasDict("groups"))
-      getGroups()->configure(*config->get("groups"));
-
-    getConfig()->configure(*config);
+    // Apply as one DB transaction and one change set
+    try {
+      Batch batch(*this);
+      if (groups) getGroups()->configure(*config->get("groups"));
+      getConfig()->configure(*config);
+      batch.commit();
+
+    } catch (...) {
+      // The transaction was rolled back, restore the config to match
+      try {
+        if (groups) getGroups()->configure(*oldGroups);
+        getConfig()->configure(*oldConfig);
+
+        for (auto &p: oldUnitGroups)
+          if (p.first->getGroup().getName() != p.second)
+            p.first->setGroup(&getGroups()->getGroup(p.second));
+      } CATCH_ERROR;
+
+      throw;
+    }
   }
 
   triggerUpdate();
@@ -307,6 +374,7 @@ void App::setState(const string &state) {
 
 bool App::getPaused() const {return getGroups()->getPaused();}
 bool App::keepAwake() const {return getGroups()->keepAwake();}
+bool App::getOnIdle() const {return getGroups()->getOnIdle();}
 
 
 void App::validate(const Certificate &cert,
@@ -379,7 +447,11 @@ uint64_t App::getNextWUID() {
 
 
 bool App::validateChange(const JSON::Value &msg) {
-  string cmd  = msg.getString("cmd");
+  return validateChange(msg, msg.getString("cmd"));
+}
+
+
+bool App::validateChange(const JSON::Value &msg, const string &cmd) {
   string time = msg.getString("time", Time().toString());
   string key  = "change-time-" + cmd;
   auto &db    = getDB("config");
@@ -395,13 +467,22 @@ bool App::validateChange(const JSON::Value &msg) {
   }
 
   // Tolerate an invalid saved time, it may be from an older client
-  uint64_t last = 0;
-  if (db.has(key)) TRY_CATCH_DEBUG(3, last = Time::parse(db.getString(key)));
+  uint64_t saved = 0;
+  if (db.has(key)) TRY_CATCH_DEBUG(3, saved = Time::parse(db.getString(key)));
+
+  // Commands in a batch often share its time, so check each against the time
+  // saved before the batch began
+  uint64_t last = saved;
+  if (batchDepth) {
+    auto it = batchChangeTimes.find(key);
+    if (it == batchChangeTimes.end()) batchChangeTimes[key] = saved;
+    else last = it->second;
+  }
 
   if (t <= last) return false; // outdated
 
   // Save change time
-  db.set(key, time);
+  if (saved < t) db.set(key, time);
 
   return true;
 }
@@ -512,6 +593,10 @@ void App::run() {
 
   // Event loop
   os->dispatch();
+  worker->shutdown();
+
+  logTracker->remove(PhonyPtr(logStore.get()));
+  logStore->shutdown();
 
   // Reduce database size
   LOG_DEBUG(3, "Vacuuming database");
@@ -546,6 +631,22 @@ void App::setup() {
   // Libevent debugging
   if (options["debug-libevent"].toBoolean()) Event::Event::enableDebugLogging();
 
+  // Log lines kept for remotes
+  logTracker->setBudget(options["log-buffer-size"].toInteger());
+
+  // Log file, never written by both the Logger and the LogWriter
+  string logFile   = options["log-file"];
+  string rotateDir = options["log-rotate-dir"];
+  if (options["log"].hasValue()) {
+    if (options["log-file"].isSet())
+      THROW("Options ``log`` and ``log-file`` cannot be used together");
+    logFile.clear();
+  }
+
+  logTracker->openLog(logFile, rotateDir,
+                      options["log-rotate-max"].toInteger(),
+                      options["log-rotate-period"].toInteger());
+
   // Load root certs
   client.getSSLContext()->loadSystemRootCerts();
 
@@ -573,21 +674,97 @@ void App::setup() {
   loadConfig();
   insert("groups", new Groups(*this));
   insert("units", new Units(*this));
+
+  // Log store
+  unsigned days = options["log-store-days"].toInteger();
+  if (days) {
+    logStore->init("logs/store", options["log-segment-size"].toInteger(), days);
+    logTracker->add(PhonyPtr(logStore.get()), 0);
+  }
 }
 
 
 void App::notify(const list<JSON::ValuePtr> &change) {
-  if (remotes.empty() || shouldQuit()) return; // Avoid many calls during init
+  if (shouldQuit()) return;
 
   // Automatically save changes to config
   bool isConfig = 2 < change.size() && change.front()->getString() == "config";
-  if (isConfig) saveEvent->activate();
+  if (isConfig) {
+    if (batchDepth) batchConfigChanged = true; // Saved in the transaction
+    else saveEvent->activate();
+  }
 
   auto changes = SmartPtr(new JSON::List(change.begin(), change.end()));
   LOG_DEBUG(5, __func__ << ' ' << *changes);
 
+  if (batchDepth) {
+    pendingBatch->append(changes);
+    return;
+  }
+
+  JSON::ValuePtr batch = new JSON::List;
+  batch->append(changes);
+  publish(batch);
+}
+
+
+void App::beginBatch() {
+  if (batchDepth++) return;
+
+  db.execute("BEGIN");
+  pendingBatch = new JSON::List;
+  batchChangeTimes.clear();
+}
+
+
+void App::endBatch() {
+  if (!batchDepth || --batchDepth) return;
+
+  JSON::ValuePtr batch = pendingBatch;
+  pendingBatch.release();
+
+  bool failed = batchFailed;
+  bool saveConfig = batchConfigChanged;
+  batchFailed = batchConfigChanged = false;
+
+  if (failed) {
+    db.execute("ROLLBACK");
+    if (batch->size())
+      LOG_WARNING("Discarded " << batch->size() << " changes of failed batch");
+    return;
+  }
+
+  try {
+    if (saveConfig) saveGlobalConfig();
+    db.execute("COMMIT");
+
+  } catch (...) {
+    TRY_CATCH_ERROR(db.execute("ROLLBACK"));
+    throw;
+  }
+
+  if (batch->size() && !shouldQuit()) publish(batch);
+}
+
+
+void App::abortBatch() {
+  batchFailed = true;
+  endBatch();
+}
+
+
+void App::publish(const JSON::ValuePtr &batch) {
+  // The journal keeps batches only while clients that can resume are around
   for (auto &remote: remotes)
-    remote->sendChanges(changes);
+    if (remote->isJournaled()) journal->use();
+  if (server->hasStreams()) journal->use();
+
+  uint64_t seq = journal->append(batch);
+
+  for (auto &remote: remotes)
+    remote->sendBatch(seq, batch);
+
+  server->sendBatch(seq, batch);
 }
 
 
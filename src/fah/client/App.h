@@ -60,6 +60,10 @@ namespace FAH {
     class OS;
     class Remote;
     class LogTracker;
+    class LogStore;
+    class Journal;
+    class WorkerThread;
+    class FileWatcher;
 
     class App :
       public cb::Application,
@@ -84,6 +88,10 @@ namespace FAH {
       cb::SmartPointer<Cores>        cores;
       cb::SmartPointer<OS>           os;
       cb::SmartPointer<LogTracker>   logTracker;
+      cb::SmartPointer<LogStore>     logStore;
+      cb::SmartPointer<Journal>      journal;
+      cb::SmartPointer<WorkerThread> worker;
+      cb::SmartPointer<FileWatcher>  watcher;
 
       std::list<cb::SmartPointer<Remote>> remotes;
 
@@ -95,6 +103,13 @@ namespace FAH {
 
       std::vector<std::string> log;
 
+      // Changes made between beginBatch() and endBatch() are sent together
+      unsigned batchDepth = 0;
+      bool batchFailed = false;
+      bool batchConfigChanged = false;
+      cb::JSON::ValuePtr pendingBatch;
+      std::map<std::string, uint64_t> batchChangeTimes;
+
     public:
       App();
       ~App();
@@ -112,6 +127,10 @@ namespace FAH {
       Cores            &getCores()      {return *cores;}
       OS               &getOS()         {return *os;}
       LogTracker       &getLogTracker() {return *logTracker;}
+      LogStore         &getLogStore()   {return *logStore;}
+      Journal          &getJournal()    {return *journal;}
+      WorkerThread     &getWorker()     {return *worker;}
+      FileWatcher      &getWatcher()    {return *watcher;}
 
       cb::SmartPointer<Groups> getGroups() const;
       cb::SmartPointer<Config> getConfig() const;
@@ -133,6 +152,7 @@ namespace FAH {
       void setState(const std::string &state);
       bool getPaused() const;
       bool keepAwake() const;
+      bool getOnIdle() const;
 
       const cb::KeyPair &getKey() const {return key;}
       void validate(const cb::Certificate &cert,
@@ -154,6 +174,11 @@ namespace FAH {
 
       bool validateChange(const cb::JSON::Value &msg);
 
+      // Use Batch rather than calling these directly
+      void beginBatch();
+      void endBatch();
+      void abortBatch();
+
       void upgradeDB();
       void loadConfig();
 
@@ -167,10 +192,12 @@ namespace FAH {
 
     protected:
       void setup();
+      bool validateChange(const cb::JSON::Value &msg, const std::string &cmd);
 
       // From cb::JSON::Value
       void notify(const std::list<cb::JSON::ValuePtr> &change) override;
 
+      void publish(const cb::JSON::ValuePtr &batch);
       void saveGlobalConfig();
     };
   }
@@ -0,0 +1,51 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+
+namespace FAH {
+  namespace Client {
+    class App;
+
+    /// Groups changes into one DB transaction and one notification.  The
+    /// batch's DB changes are rolled back and its notifications not sent
+    /// unless commit() is called.  In memory state is not restored, callers
+    /// that abort must undo it themselves.
+    class Batch {
+      App &app;
+      bool done = false;
+
+    public:
+      Batch(App &app);
+      ~Batch();
+
+      void commit();
+    };
+  }
+}
@@ -0,0 +1,252 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "CBORReader.h"
+
+#include <cbang/Exception.h>
+#include <cbang/json/Builder.h>
+
+#include <cmath>
+#include <cstring>
+
+using namespace FAH::Client;
+using namespace cb;
+using namespace std;
+
+
+namespace {
+  const unsigned maxDepth = 256;
+  const uint8_t  indefinite = 31;
+  const uint8_t  cborBreak  = 0xff;
+}
+
+
+CBORReader::CBORReader(const char *data, uint64_t length) :
+  data((const uint8_t *)data), end((const uint8_t *)data + length) {}
+
+
+JSON::ValuePtr CBORReader::parse(const char *data, uint64_t length) {
+  JSON::Builder builder;
+  CBORReader reader(data, length);
+
+  reader.read(builder);
+  if (reader.data != reader.end) THROW("Trailing data after CBOR value");
+
+  return builder.getRoot();
+}
+
+
+void CBORReader::read(JSON::Sink &sink) {
+  if (maxDepth < ++depth) THROW("CBOR nesting too deep");
+
+  uint8_t head  = next();
+  uint8_t major = head >> 5;
+  uint8_t info  = head & 0x1f;
+
+  switch (major) {
+  case 0: sink.write((double)readArgument(info)); break;
+  case 1: sink.write(-1 - (double)readArgument(info)); break;
+  case 2: case 3: sink.write(readString(major, info)); break;
+
+  case 4: { // Array
+    sink.beginList();
+
+    if (info == indefinite) {
+      while (peek() != cborBreak) {
+        sink.beginAppend();
+        read(sink);
+      }
+
+      next(); // Break
+
+    } else
+      for (uint64_t n = readArgument(info); n; n--) {
+        sink.beginAppend();
+        read(sink);
+      }
+
+    sink.endList();
+    break;
+  }
+
+  case 5: { // Map
+    sink.beginDict();
+    uint64_t n = info == indefinite ? 0 : readArgument(info);
+
+    while (info == indefinite ? peek() != cborBreak : 0 < n--) {
+      uint8_t keyHead = next();
+      uint8_t keyMajor = keyHead >> 5;
+      if (keyMajor != 3) THROW("CBOR map keys must be text strings");
+
+      sink.beginInsert(readString(keyMajor, keyHead & 0x1f));
+      read(sink);
+    }
+
+    if (info == indefinite) next(); // Break
+    sink.endDict();
+    break;
+  }
+
+  case 6: { // Tag
+    uint64_t tag = readArgument(info);
+    if (tag == 85 || tag == 86) readTypedArray(sink, tag);
+    else read(sink); // Ignore unknown tags, each one counts toward maxDepth
+    break;
+  }
+
+  case 7:
+    switch (info) {
+    case 20: sink.writeBoolean(false); break;
+    case 21: sink.writeBoolean(true);  break;
+    case 22: case 23: sink.writeNull(); break;
+    case 25: sink.write(readFloat(2)); break;
+    case 26: sink.write(readFloat(4)); break;
+    case 27: sink.write(readFloat(8)); break;
+    default: THROW("Unsupported CBOR simple value " << (unsigned)info);
+    }
+    break;
+  }
+
+  depth--;
+}
+
+
+uint8_t CBORReader::peek() const {
+  if (end <= data) THROW("Truncated CBOR");
+  return *data;
+}
+
+
+uint8_t CBORReader::next() {
+  if (end <= data) THROW("Truncated CBOR");
+  return *data++;
+}
+
+
+uint64_t CBORReader::readUInt(unsigned bytes) {
+  uint64_t x = 0;
+  for (unsigned i = 0; i < bytes; i++) x = (x << 8) | next();
+  return x;
+}
+
+
+uint64_t CBORReader::readArgument(uint8_t info) {
+  if (info < 24) return info;
+
+  switch (info) {
+  case 24: return readUInt(1);
+  case 25: return readUInt(2);
+  case 26: return readUInt(4);
+  case 27: return readUInt(8);
+  default: THROW("Invalid CBOR argument " << (unsigned)info);
+  }
+}
+
+
+string CBORReader::readString(uint8_t major, uint8_t info) {
+  if (info == indefinite) {
+    string s;
+
+    while (true) {
+      uint8_t head = next();
+      if (head == cborBreak) return s;
+      if (head >> 5 != major || (head & 0x1f) == indefinite)
+        THROW("Invalid CBOR string chunk");
+      s += readString(major, head & 0x1f);
+    }
+  }
+
+  uint64_t length = readArgument(info);
+  if ((uint64_t)(end - data) < length) THROW("Truncated CBOR");
+
+  string s((const char *)data, length);
+  data += length;
+  return s;
+}
+
+
+double CBORReader::readFloat(unsigned bytes) {
+  uint64_t bits = readUInt(bytes);
+
+  if (bytes == 2) { // Half precision
+    int exp  = (bits >> 10) & 0x1f;
+    int mant = bits & 0x3ff;
+    double x;
+
+    if (!exp) x = ldexp(mant, -24);
+    else if (exp != 31) x = ldexp(mant + 1024, exp - 25);
+    else x = mant ? NAN : INFINITY;
+
+    return (bits & 0x8000) ? -x : x;
+  }
+
+  if (bytes == 4) {
+    uint32_t b = bits;
+    float f;
+    memcpy(&f, &b, sizeof(f));
+    return f;
+  }
+
+  double d;
+  memcpy(&d, &bits, sizeof(d));
+  return d;
+}
+
+
+void CBORReader::readTypedArray(JSON::Sink &sink, uint64_t tag) {
+  uint8_t head = next();
+  if (head >> 5 != 2) THROW("CBOR typed array must be a byte string");
+
+  string bytes = readString(2, head & 0x1f);
+  unsigned width = tag == 85 ? 4 : 8;
+  if (bytes.size() % width) THROW("Invalid CBOR typed array length");
+
+  sink.beginList();
+
+  for (unsigned i = 0; i < bytes.size(); i += width) {
+    uint64_t bits = 0;
+    for (unsigned j = 0; j < width; j++)
+      bits |= (uint64_t)(uint8_t)bytes[i + j] << (8 * j);
+
+    sink.beginAppend();
+
+    if (width == 4) {
+      uint32_t b = bits;
+      float f;
+      memcpy(&f, &b, sizeof(f));
+      sink.write((double)f);
+
+    } else {
+      double d;
+      memcpy(&d, &bits, sizeof(d));
+      sink.write(d);
+    }
+  }
+
+  sink.endList();
+}
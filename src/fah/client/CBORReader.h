@@ -0,0 +1,64 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/json/Sink.h>
+
+#include <string>
+
+
+namespace FAH {
+  namespace Client {
+    /// Decodes CBOR (RFC 8949) in to a JSON::Sink.  Float typed arrays
+    /// (RFC 8746) are read as lists of numbers.
+    class CBORReader {
+      const uint8_t *data;
+      const uint8_t *end;
+      unsigned depth = 0;
+
+    public:
+      CBORReader(const char *data, uint64_t length);
+
+      static cb::JSON::ValuePtr parse(const char *data, uint64_t length);
+      static cb::JSON::ValuePtr parse(const std::string &s)
+        {return parse(s.data(), s.size());}
+
+      void read(cb::JSON::Sink &sink);
+
+    protected:
+      uint8_t peek() const;
+      uint8_t next();
+      uint64_t readUInt(unsigned bytes);
+      uint64_t readArgument(uint8_t info);
+      std::string readString(uint8_t major, uint8_t info);
+      double readFloat(unsigned bytes);
+      void readTypedArray(cb::JSON::Sink &sink, uint64_t tag);
+    };
+  }
+}
@@ -0,0 +1,210 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "CBORWriter.h"
+
+#include <cmath>
+#include <cstring>
+
+using namespace FAH::Client;
+using namespace cb;
+using namespace std;
+
+
+namespace {
+  enum {
+    CBOR_UINT   = 0,
+    CBOR_NEGINT = 1,
+    CBOR_BYTES  = 2,
+    CBOR_TEXT   = 3,
+    CBOR_ARRAY  = 4,
+    CBOR_MAP    = 5,
+    CBOR_TAG    = 6,
+    CBOR_SIMPLE = 7,
+  };
+
+  const uint8_t  cborFalse   = 0xf4;
+  const uint8_t  cborTrue    = 0xf5;
+  const uint8_t  cborNull    = 0xf6;
+  const uint8_t  cborFloat32 = 0xfa;
+  const uint8_t  cborFloat64 = 0xfb;
+  const uint64_t tagFloat32LE = 85; // RFC 8746 typed arrays
+  const uint64_t tagFloat64LE = 86;
+
+  const unsigned minTypedArray = 2;
+
+
+  bool isFloat32(double n) {return (double)(float)n == n || std::isnan(n);}
+
+
+  bool isInteger(double n) {
+    return std::isfinite(n) && floor(n) == n && -9.2e18 < n && n < 1.8e19;
+  }
+
+
+  template <typename T>
+  void appendBE(string &out, T x) {
+    for (int i = sizeof(T) - 1; 0 <= i; i--)
+      out.push_back((char)(x >> (8 * i)));
+  }
+
+
+  template <typename T>
+  void appendLE(string &out, T x) {
+    for (unsigned i = 0; i < sizeof(T); i++)
+      out.push_back((char)(x >> (8 * i)));
+  }
+}
+
+
+string CBORWriter::encode(const JSON::Value &value) {
+  string out;
+  CBORWriter(out).write(value);
+  return out;
+}
+
+
+void CBORWriter::write(const JSON::Value &value) {
+  if (value.isNull() || value.isUndefined()) out.push_back(cborNull);
+  else if (value.isBoolean())
+    out.push_back(value.getBoolean() ? cborTrue : cborFalse);
+  else if (value.isNumber()) writeNumber(value.getNumber());
+  else if (value.isString()) writeString(value.getString());
+
+  else if (value.isList()) {
+    if (writeTypedArray(value)) return;
+
+    writeHead(CBOR_ARRAY, value.size());
+    for (unsigned i = 0; i < value.size(); i++)
+      write(*value.get(i));
+
+  } else if (value.isDict()) {
+    writeHead(CBOR_MAP, value.size());
+    for (unsigned i = 0; i < value.size(); i++) {
+      writeString(value.keyAt(i));
+      write(*value.get(i));
+    }
+
+  } else out.push_back(cborNull);
+}
+
+
+void CBORWriter::writeHead(uint8_t major, uint64_t n) {
+  uint8_t type = major << 5;
+
+  if (n < 24) out.push_back((char)(type | n));
+  else if (n <= 0xff) {
+    out.push_back((char)(type | 24));
+    out.push_back((char)n);
+
+  } else if (n <= 0xffff) {
+    out.push_back((char)(type | 25));
+    appendBE<uint16_t>(out, n);
+
+  } else if (n <= 0xffffffff) {
+    out.push_back((char)(type | 26));
+    appendBE<uint32_t>(out, n);
+
+  } else {
+    out.push_back((char)(type | 27));
+    appendBE<uint64_t>(out, n);
+  }
+}
+
+
+void CBORWriter::writeNumber(double n) {
+  if (isInteger(n)) {
+    if (0 <= n) writeHead(CBOR_UINT, (uint64_t)n);
+    else writeHead(CBOR_NEGINT, (uint64_t)(-1 - (int64_t)n));
+    return;
+  }
+
+  if (isFloat32(n)) {
+    float f = n;
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    out.push_back(cborFloat32);
+    appendBE(out, bits);
+
+  } else {
+    uint64_t bits;
+    memcpy(&bits, &n, sizeof(bits));
+    out.push_back(cborFloat64);
+    appendBE(out, bits);
+  }
+}
+
+
+void CBORWriter::writeString(const string &s) {
+  writeHead(CBOR_TEXT, s.size());
+  out.append(s);
+}
+
+
+bool CBORWriter::writeTypedArray(const JSON::Value &list) {
+  // Only lists of numbers with at least one fraction, integer lists are
+  // already compact as plain CBOR arrays
+  unsigned size = list.size();
+  if (size < minTypedArray) return false;
+
+  bool hasFraction = false;
+  bool allFloat32  = true;
+
+  for (unsigned i = 0; i < size; i++) {
+    auto &v = *list.get(i);
+    if (!v.isNumber()) return false;
+
+    double n = v.getNumber();
+    if (!isInteger(n)) hasFraction = true;
+    if (!isFloat32(n)) allFloat32  = false;
+  }
+
+  if (!hasFraction) return false;
+
+  unsigned width = allFloat32 ? 4 : 8;
+  writeHead(CBOR_TAG, allFloat32 ? tagFloat32LE : tagFloat64LE);
+  writeHead(CBOR_BYTES, (uint64_t)size * width);
+
+  for (unsigned i = 0; i < size; i++) {
+    double n = list.get(i)->getNumber();
+
+    if (allFloat32) {
+      float f = n;
+      uint32_t bits;
+      memcpy(&bits, &f, sizeof(bits));
+      appendLE(out, bits);
+
+    } else {
+      uint64_t bits;
+      memcpy(&bits, &n, sizeof(bits));
+      appendLE(out, bits);
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,57 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/json/Value.h>
+
+#include <string>
+
+
+namespace FAH {
+  namespace Client {
+    /// Encodes JSON values as CBOR (RFC 8949).  Lists of non-integer numbers
+    /// are written as little-endian float typed arrays (RFC 8746).
+    class CBORWriter {
+      std::string &out;
+
+    public:
+      CBORWriter(std::string &out) : out(out) {}
+
+      static std::string encode(const cb::JSON::Value &value);
+
+      void write(const cb::JSON::Value &value);
+
+    protected:
+      void writeHead(uint8_t major, uint64_t n);
+      void writeNumber(double n);
+      void writeString(const std::string &s);
+      bool writeTypedArray(const cb::JSON::Value &list);
+    };
+  }
+}
@@ -66,9 +66,22 @@ void Config::load(const Options &opts) {
 }
 
 
+void Config::validate(const JSON::Value &config) const {
+  if (!config.isDict()) THROW("Config must be a dictionary");
+
+  for (auto it = config.begin(); it != config.end(); it++)
+    if (defaults->has(it.key()) &&
+        defaults->get(it.key())->getType() != (*it)->getType())
+      THROW("Config key '" << it.key() << "' has wrong type "
+            << (*it)->getType());
+}
+
+
 void Config::configure(const JSON::Value &config) {
+  // Only changed values, so unchanged keys cause no notifications
   for (auto it = config.begin(); it != config.end(); it++)
-    if (has(it.key())) insert(it.key(), *it);
+    if (has(it.key()) && get(it.key())->toString() != (*it)->toString())
+      insert(it.key(), *it);
 }
 
 
@@ -124,12 +137,19 @@ uint32_t Config::getCPUs() const {
 }
 
 
-std::set<string> Config::getGPUs() const {
-  std::set<string> gpus;
+const std::set<string> &Config::getGPUs() const {
+  auto &resources = app.getGPUs();
+
+  if (!gpusValid || gpusGeneration != resources.getGeneration()) {
+    gpus.clear();
 
-  for (auto &v: app.getGPUs()) {
-    auto &gpu = *v.cast<GPUResource>();
-    if (gpu.isSupported(*this)) gpus.insert(gpu.getID());
+    for (auto &v: resources) {
+      auto &gpu = *v.cast<GPUResource>();
+      if (gpu.isSupported(*this)) gpus.insert(gpu.getID());
+    }
+
+    gpusValid = true;
+    gpusGeneration = resources.getGeneration();
   }
 
   return gpus;
@@ -154,6 +174,15 @@ void Config::disableGPU(const string &id) {
 }
 
 
+void Config::notify(const list<JSON::ValuePtr> &change) {
+  if (change.empty()) return;
+
+  string key = change.front()->getString();
+  if (key == "gpus" || key == "cuda" || key == "hip" || key == "opencl")
+    gpusValid = false;
+}
+
+
 JSON::Value::iterator Config::insert(
   const string &key, const JSON::ValuePtr &value) {
   if (!defaults->has(key)) {
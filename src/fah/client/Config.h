@@ -40,6 +40,11 @@ namespace FAH {
       App &app;
       cb::JSON::ValuePtr defaults;
 
+      // Supported GPUs, valid while the config and GPU inventory are unchanged
+      mutable bool gpusValid = false;
+      mutable uint64_t gpusGeneration = 0;
+      mutable std::set<std::string> gpus;
+
       typedef cb::JSON::ObservableDict Super_T;
 
     public:
@@ -48,6 +53,7 @@ namespace FAH {
       void load(const cb::JSON::Value &config);
       void load(const cb::Options &opts);
 
+      void validate(const cb::JSON::Value &config) const;
       void configure(const cb::JSON::Value &config);
       void setState(const cb::JSON::Value &msg);
 
@@ -64,12 +70,13 @@ namespace FAH {
       bool getBeta(const std::set<std::string> &gpus) const;
 
       uint32_t getCPUs() const;
-      std::set<std::string> getGPUs() const;
+      const std::set<std::string> &getGPUs() const;
       bool isGPUEnabled(const std::string &id) const;
       bool isComputeDeviceEnabled(const std::string &type) const;
       void disableGPU(const std::string &id);
 
       // From JSON::Value
+      void notify(const std::list<cb::JSON::ValuePtr> &change) override;
       cb::JSON::Value::iterator insert(const std::string &key,
         const cb::JSON::ValuePtr &value) override;
       using Super_T::insert;
@@ -201,7 +201,7 @@ void Core::downloadResponse(const string &pkg) {
   state = CORE_TEST;
   process = SmartPtr(new CoreProcess(filename));
   process->exec({"--info"});
-  nextEvent->add(0.25);
+  process->onExit(app.getEventBase(), [this] {nextEvent->activate();});
 }
 
 
@@ -254,7 +254,7 @@ void Core::response(HTTP::Request &req) {
 
 
 void Core::test() {
-  if (process->isRunning()) return nextEvent->add(0.25);
+  if (process->isRunning()) return; // Called again on exit
 
   auto code = process->wait();
   if (code) {
@@ -32,6 +32,15 @@
 #include <cbang/os/SystemUtilities.h>
 #include <cbang/log/Logger.h>
 
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+#include <signal.h>
+#endif
+
 using namespace FAH::Client;
 using namespace cb;
 using namespace std;
@@ -53,6 +62,14 @@ CoreProcess::CoreProcess(const std::string &path) :
 }
 
 
+CoreProcess::~CoreProcess() {
+  if (exitEvent.isSet()) exitEvent->del();
+#ifdef __linux__
+  if (0 <= pidfd) close(pidfd);
+#endif
+}
+
+
 void CoreProcess::exec(const vector<string> &_args) {
   vector<string> args;
   args.push_back(path);
@@ -76,3 +93,43 @@ void CoreProcess::stop() {
     interruptTime = 1; // Prevent further interrupt or kill
   }
 }
+
+
+void CoreProcess::onExit(Event::Base &base, function<void ()> cb) {
+  // Checked after each event, the process may have been reaped already
+  auto check = [this, cb] {
+    if (isRunning()) return;
+    exitEvent->del();
+    cb();
+  };
+
+#ifdef __linux__
+  // A pidfd becomes readable when the process exits, requires Linux 5.3
+#ifdef SYS_pidfd_open
+  pidfd = syscall(SYS_pidfd_open, getPID(), 0);
+#endif
+
+  if (0 <= pidfd) {
+    exitEvent = base.newEvent(
+      pidfd, [check] (Event::Event &, int, unsigned) {check();},
+      Event::Event::EVENT_READ | Event::Event::EVENT_PERSIST);
+    exitEvent->add();
+    return;
+  }
+#endif
+
+#ifndef _WIN32
+  // SIGCHLD is raised for any child, check if it was this one
+  exitEvent = base.newSignal(SIGCHLD, check);
+  exitEvent->add();
+  check(); // In case it already exited
+
+#else
+  // No exit notification, check periodically
+  exitEvent = base.newEvent([this, cb] {
+    if (isRunning()) exitEvent->add(0.25);
+    else cb();
+  }, 0);
+  exitEvent->add(0.25);
+#endif
+}
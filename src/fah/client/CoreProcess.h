@@ -29,6 +29,10 @@
 #pragma once
 
 #include <cbang/os/Subprocess.h>
+#include <cbang/event/Base.h>
+#include <cbang/event/Event.h>
+
+#include <functional>
 
 
 namespace FAH {
@@ -36,12 +40,20 @@ namespace FAH {
     class CoreProcess : public cb::Subprocess {
       const std::string path;
       uint64_t interruptTime = 0;
+      int pidfd = -1;
+      cb::Event::EventPtr exitEvent;
 
     public:
       CoreProcess(const std::string &path);
+      ~CoreProcess();
 
       void exec(const std::vector<std::string> &args);
       void stop();
+
+      /// Calls @param cb from the event loop once the process has exited.
+      /// The process may be freed by then, so @param cb should only
+      /// schedule work.
+      void onExit(cb::Event::Base &base, std::function<void ()> cb);
     };
   }
 }
@@ -0,0 +1,147 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "EventStream.h"
+#include "App.h"
+#include "Server.h"
+#include "Journal.h"
+
+#include <cbang/String.h>
+#include <cbang/log/Logger.h>
+#include <cbang/event/Base.h>
+#include <cbang/http/Conn.h>
+
+using namespace FAH::Client;
+using namespace cb;
+using namespace std;
+
+
+EventStream::EventStream(App &app, HTTP::Request &req) :
+  app(app), req(&req) {
+  auto &uri = req.getURI();
+
+  // Only stream changes to the listed top-level keys, e.g. "units,groups"
+  if (uri.has("filter")) {
+    vector<string> keys;
+    String::tokenize(uri.get("filter"), keys, ",");
+    filter.insert(keys.begin(), keys.end());
+  }
+}
+
+
+void EventStream::open() {
+  auto &journal = app.getJournal();
+
+  // Browsers send Last-Event-ID automatically when reconnecting
+  string lastID;
+  if (req->inHas("Last-Event-ID")) lastID = req->inGet("Last-Event-ID");
+  else if (req->getURI().has("last-event-id"))
+    lastID = req->getURI().get("last-event-id");
+
+  string id;
+  uint64_t since = 0;
+  size_t dash = lastID.rfind('-');
+  if (dash != string::npos) {
+    id = lastID.substr(0, dash);
+    since = String::parseU64(lastID.substr(dash + 1));
+  }
+
+  req->outSet("Content-Type", "text/event-stream");
+  req->outSet("Cache-Control", "no-cache");
+  req->startChunked(HTTP_OK);
+
+  keepAliveEvent = app.getEventBase().newEvent([this] {keepAlive();}, 0);
+  keepAliveEvent->add(15);
+
+  if (journal.canResume(id, since))
+    journal.replay(since, [this] (uint64_t seq, const JSON::ValuePtr &b) {
+      sendBatch(seq, b);
+    });
+
+  else sendState(journal.getSeq());
+}
+
+
+void EventStream::close() {
+  if (closed) return;
+  closed = true;
+
+  if (keepAliveEvent.isSet()) keepAliveEvent->del();
+
+  auto conn = req->getConnection().toStrongPtr();
+  if (conn.isSet()) conn->close();
+
+  app.getServer().streamClosed();
+}
+
+
+void EventStream::sendBatch(uint64_t seq, const JSON::ValuePtr &batch) {
+  if (closed) return;
+
+  JSON::ValuePtr changes = new JSON::List;
+  for (auto change: *batch)
+    if (matches(*change)) changes->append(change);
+  if (!changes->size()) return;
+
+  write("id: " + app.getJournal().getID() + "-" + String(seq) + "\n"
+        "data: " + changes->toString(0, true) + "\n\n");
+}
+
+
+bool EventStream::matches(const JSON::Value &changes) const {
+  return filter.empty() ||
+    (changes.size() && filter.count(changes.getString(0)));
+}
+
+
+void EventStream::sendState(uint64_t seq) {
+  JSON::ValuePtr state = new JSON::Dict;
+
+  for (unsigned i = 0; i < app.size(); i++)
+    if (filter.empty() || filter.count(app.keyAt(i)))
+      state->insert(app.keyAt(i), app.get(i));
+
+  write("event: state\nid: " + app.getJournal().getID() + "-" + String(seq) +
+        "\ndata: " + state->toString(0, true) + "\n\n");
+}
+
+
+void EventStream::write(const string &data) {
+  try {
+    if (!req->getConnection().toStrongPtr().isSet()) THROW("Disconnected");
+    req->sendChunk(data.data(), data.size());
+    keepAliveEvent->add(15);
+
+  } catch (const Exception &e) {
+    LOG_DEBUG(3, "Event stream closed: " << e.getMessage());
+    close();
+  }
+}
+
+
+void EventStream::keepAlive() {write(": keep-alive\n\n");}
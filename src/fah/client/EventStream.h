@@ -0,0 +1,66 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/json/Value.h>
+#include <cbang/event/Event.h>
+#include <cbang/http/Request.h>
+
+#include <set>
+
+
+namespace FAH {
+  namespace Client {
+    class App;
+
+    /// One-way Server-Sent Events stream of the change journal
+    class EventStream : public cb::RefCounted {
+      App &app;
+      cb::SmartPointer<cb::HTTP::Request> req;
+      cb::Event::EventPtr keepAliveEvent;
+      std::set<std::string> filter;
+      bool closed = false;
+
+    public:
+      EventStream(App &app, cb::HTTP::Request &req);
+
+      bool isClosed() const {return closed;}
+
+      void open();
+      void close();
+      void sendBatch(uint64_t seq, const cb::JSON::ValuePtr &batch);
+
+    protected:
+      bool matches(const cb::JSON::Value &changes) const;
+      void sendState(uint64_t seq);
+      void write(const std::string &data);
+      void keepAlive();
+    };
+  }
+}
@@ -0,0 +1,151 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "FileWatcher.h"
+#include "App.h"
+
+#include <cbang/Catch.h>
+#include <cbang/os/SysError.h>
+#include <cbang/log/Logger.h>
+#include <cbang/event/Base.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+using namespace FAH::Client;
+using namespace cb;
+using namespace std;
+
+
+FileWatcher::FileWatcher(App &app) : app(app) {}
+
+
+FileWatcher::~FileWatcher() {
+  if (event.isSet()) event->del();
+#ifdef __linux__
+  if (0 <= fd) ::close(fd);
+#endif
+}
+
+
+int FileWatcher::watch(const string &dir, callback_t cb) {
+#ifdef __linux__
+  if (!open()) return -1;
+
+  // Not IN_MODIFY, cores write their logs and checkpoints continuously
+  const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR;
+  int id = inotify_add_watch(fd, dir.c_str(), mask);
+
+  if (id < 0) {
+    LOG_DEBUG(3, "Cannot watch " << dir << ": " << SysError());
+    return -1;
+  }
+
+  watches[id] = cb;
+  return id;
+
+#else
+  return -1;
+#endif
+}
+
+
+void FileWatcher::unwatch(int id) {
+  if (id < 0 || !watches.erase(id)) return;
+#ifdef __linux__
+  inotify_rm_watch(fd, id);
+#endif
+}
+
+
+bool FileWatcher::open() {
+#ifdef __linux__
+  if (0 <= fd) return true;
+  if (failed) return false;
+
+  fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+  if (fd < 0) {
+    LOG_WARNING("inotify unavailable, polling work files: " << SysError());
+    failed = true;
+    return false;
+  }
+
+  event = app.getEventBase().newEvent(
+    fd, [this] (Event::Event &, int, unsigned) {read();},
+    Event::Event::EVENT_READ | Event::Event::EVENT_PERSIST);
+  event->add();
+
+  return true;
+
+#else
+  return false;
+#endif
+}
+
+
+void FileWatcher::read() {
+#ifdef __linux__
+  alignas(inotify_event) char buffer[4096];
+
+  while (true) {
+    ssize_t len = ::read(fd, buffer, sizeof(buffer));
+
+    if (len <= 0) {
+      if (len < 0 && errno == EINTR) continue;
+      if (len < 0 && errno != EAGAIN)
+        LOG_WARNING("inotify read failed: " << SysError());
+      break;
+    }
+
+    for (ssize_t i = 0; i < len;) {
+      auto &e = *(inotify_event *)&buffer[i];
+      i += sizeof(inotify_event) + e.len;
+
+      if (e.mask & IN_Q_OVERFLOW) {
+        auto watches = this->watches;
+        for (auto &p: watches) TRY_CATCH_ERROR(p.second("*"));
+        continue;
+      }
+
+      // Callbacks may unwatch, so look the watch up for each event
+      auto it = watches.find(e.wd);
+      if (it == watches.end()) continue;
+      auto cb = it->second;
+
+      if (e.mask & IN_IGNORED) watches.erase(it);
+      else if (!e.len) continue;
+
+      TRY_CATCH_ERROR(cb(e.mask & IN_IGNORED ? string() : string(e.name)));
+    }
+  }
+#endif
+}
@@ -0,0 +1,71 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/event/Event.h>
+
+#include <map>
+#include <string>
+#include <functional>
+
+
+namespace FAH {
+  namespace Client {
+    class App;
+
+    /// Reports changes to files in watched directories.  Uses inotify on
+    /// Linux, elsewhere watch() fails and callers should keep polling.
+    class FileWatcher {
+    public:
+      /// Called with the changed file's name, "*" if events were lost or an
+      /// empty name if the watch was removed because the directory went away.
+      /// After "*" callers should unwatch and poll instead.
+      typedef std::function<void (const std::string &name)> callback_t;
+
+    private:
+      App &app;
+      int fd = -1;
+      bool failed = false;
+      cb::Event::EventPtr event;
+      std::map<int, callback_t> watches;
+
+    public:
+      FileWatcher(App &app);
+      ~FileWatcher();
+
+      /// @return a watch ID or -1 if @param dir cannot be watched
+      int watch(const std::string &dir, callback_t cb);
+      void unwatch(int id);
+
+    protected:
+      bool open();
+      void read();
+    };
+  }
+}
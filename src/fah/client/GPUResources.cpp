@@ -92,6 +92,11 @@ bool GPUResources::waitOnGPU(const string &id) const {
 }
 
 
+void GPUResources::notify(const list<JSON::ValuePtr> &change) {
+  generation++;
+}
+
+
 void GPUResources::load(const JSON::Value &gpus) {
   gpuIndex.read(gpus);
   loaded = true;
@@ -239,9 +244,9 @@ void GPUResources::detect() {
   if (unconfiguredGPUs.size() && app.getUptime() < maxWaitTime)
     detectEvent->add(5); // Try again later
 
+  // Groups waiting on GPUs are only updated when triggered
+  bool waiting = !detected || unconfiguredGPUs.size();
   detected = true;
-  if (changed) {
-    LOG_INFO(3, "gpus = " << *this);
-    app.triggerUpdate();
-  }
+  if (changed) LOG_INFO(3, "gpus = " << *this);
+  if (changed || waiting) app.triggerUpdate();
 }
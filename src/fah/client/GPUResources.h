@@ -49,6 +49,7 @@ namespace FAH {
       int64_t lastGPUsFail = 0;
       std::set<std::string> unconfiguredGPUs;
       const unsigned maxWaitTime = 5 * 60;
+      uint64_t generation = 0;
 
       cb::Event::EventPtr updateEvent;
       cb::Event::EventPtr detectEvent;
@@ -58,8 +59,13 @@ namespace FAH {
       GPUResources(App &app);
       ~GPUResources();
 
+      /// Changes whenever a GPU is added, removed or modified
+      uint64_t getGeneration() const {return generation;}
       bool waitOnGPU(const std::string &id) const;
 
+      // From cb::JSON::Value
+      void notify(const std::list<cb::JSON::ValuePtr> &change) override;
+
     protected:
       void load(const cb::JSON::Value &gpus);
       void response(cb::HTTP::Request &req);
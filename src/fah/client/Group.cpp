@@ -37,6 +37,7 @@
 #include <cbang/json/Reader.h>
 
 #include <cmath>
+#include <algorithm>
 
 using namespace std;
 using namespace cb;
@@ -50,7 +51,8 @@ namespace FAH {namespace Client {extern const DirectoryResource resource0;}}
 
 Group::Group(App &app, const string &name) :
   app(app), name(name),
-  event(app.getEventBase().newEvent([this] {update();}, 0)) {
+  event(app.getEventBase().newEvent([this] {update();}, 0)),
+  waitEvent(app.getEventBase().newEvent([this] {triggerUpdate();}, 0)) {
   auto &r       = FAH::Client::resource0.get("group.json");
   auto defaults = JSON::Reader::parse(r);
   config        = new Config(app, defaults);
@@ -69,7 +71,13 @@ Group::Group(App &app, const string &name) :
 }
 
 
-Group::Units Group::units() const {return Units(*app.getUnits(), name);}
+void Group::addUnit(Unit *unit) {unitList.push_back(unit);}
+
+
+void Group::removeUnit(Unit *unit) {
+  auto it = find(unitList.begin(), unitList.end(), unit);
+  if (it != unitList.end()) unitList.erase(it);
+}
 
 
 void Group::setState(const JSON::Value &msg) {
@@ -185,20 +193,20 @@ void Group::update() {
   for (auto unit: units())
     unit->triggerNext();
 
-  // Remove completed units
-  std::set<string> completed;
+  // Remove completed units, by pointer since some never got an ID
+  units_t completed;
   for (auto unit: units())
     if (unit->getState() == UnitState::UNIT_DONE)
-      completed.insert(unit->getID());
+      completed.push_back(unit);
 
-  for (auto &id: completed)
-    app.getUnits()->removeUnit(id);
+  for (auto unit: completed)
+    app.getUnits()->removeUnit(unit);
 
   // Handle graceful shutdown
   if (app.shouldQuit()) {
     for (auto unit: units())
       if (unit->isRunning())
-        return event->add(0.25); // Check again later
+        return; // Units trigger an update when their core exits
 
     if (shutdownCB) {
       // Save state to DB
@@ -212,28 +220,31 @@ void Group::update() {
     return;
   }
 
-  // No further action if waiting
+  // No further action if waiting.  Config, OS, GPU and unit state changes
+  // trigger an update, only the backoff needs a timer.
   if (config->getPaused() || waitForIdle() || waitOnBattery() || waitOnGPU() ||
-      isAssigning() || Time::now() < waitUntil)
-    return event->add(0.25); // Check again later
+      isAssigning()) return;
+
+  uint64_t now = Time::now();
+  if (now < waitUntil) return waitEvent->add(waitUntil - now);
 
   // Allocate resources
   unsigned         remainingCPUs = config->getCPUs();
-  std::set<string> remainingGPUs = config->getGPUs();
+  std::set<string> remainingGPUs = config->getGPUs(); // Copy, allocated below
   std::set<string> enabledWUs;
 
   // Allocate GPUs with minimum CPU requirements
   for (auto unit: units()) {
     if (UNIT_RUN < unit->getState()) continue;
 
-    auto unitGPUs = unit->getGPUs();
+    auto &unitGPUs = unit->getGPUs();
     if (unitGPUs.empty()) continue;
 
     uint32_t minCPUs  = unit->getMinCPUs();
     bool     runnable = minCPUs <= remainingCPUs || minCPUs < 2;
 
     std::set<string> gpusWithWU = remainingGPUs;
-    for (auto id: unitGPUs) runnable &= gpusWithWU.erase(id) != 0;
+    for (auto &id: unitGPUs) runnable &= gpusWithWU.erase(id) != 0;
 
     if (runnable) {
       remainingGPUs = gpusWithWU;
@@ -31,6 +31,7 @@
 #include "Units.h"
 
 #include <functional>
+#include <vector>
 
 
 namespace FAH {
@@ -44,52 +45,27 @@ namespace FAH {
       cb::SmartPointer<Config> config;
 
       cb::Event::EventPtr event;
+      cb::Event::EventPtr waitEvent; // Ends the failure backoff
       uint32_t lostWUs    = 0;
       uint32_t failures   = 0;
       uint64_t waitUntil  = 0;
 
       std::function<void ()> shutdownCB;
 
+    public:
+      typedef std::vector<Unit *> units_t;
 
-      struct UnitIterator : public cb::JSON::Iterator {
-        const std::string &group;
-
-        UnitIterator(const cb::JSON::Iterator &it, const std::string &group) :
-          cb::JSON::Iterator(it), group(group) {next();}
-
-        UnitIterator &operator++() {
-          cb::JSON::Iterator::operator++();
-          next();
-          return *this;
-        }
-
-        cb::SmartPointer<Unit> operator*() const {
-          return cb::JSON::Iterator::operator*().cast<Unit>();
-        }
-
-      private:
-        void next() {
-          while (operator bool() && (**this)->getGroup().getName() != group)
-            cb::JSON::Iterator::operator++();
-        }
-      };
-
-
-      struct Units {
-        const Value &value;
-        const std::string &group;
-        Units(const Value &value, const std::string &group) :
-          value(value), group(group) {}
-        UnitIterator begin() const {return UnitIterator(value.begin(), group);}
-        UnitIterator end()   const {return UnitIterator(value.end(),   group);}
-      };
+    private:
+      units_t unitList; // Kept in sync by Unit and Units::removeUnit()
 
    public:
       Group(App &app, const std::string &name);
 
       const std::string &getName() const {return name;}
       Config &getConfig() const {return *config;}
-      Units units() const;
+      const units_t &units() const {return unitList;}
+      void addUnit(Unit *unit);
+      void removeUnit(Unit *unit);
 
       void setState(const cb::JSON::Value &msg);
 
@@ -80,7 +80,8 @@ void Groups::delGroup(const string &name) {
   auto &group = getGroup(name);
   auto &root  = getGroup("");
 
-  for (auto unit: group.units())
+  auto units = group.units(); // Copy, setGroup() modifies the list
+  for (auto unit: units)
     unit->setGroup(&root);
 
   // Remove from DB
@@ -91,6 +92,16 @@ void Groups::delGroup(const string &name) {
 }
 
 
+void Groups::validate(const JSON::Value &configs) const {
+  if (!configs.isDict()) THROW("Group configs must be a dictionary");
+
+  // All groups share the same defaults
+  auto &config = getGroup("").getConfig();
+  for (auto it = configs.begin(); it != configs.end(); it++)
+    config.validate(**it);
+}
+
+
 void Groups::configure(const JSON::Value &configs) {
   // Delete removed groups
   std::set<string> remove;
@@ -142,3 +153,12 @@ bool Groups::keepAwake() const {
 
   return false;
 }
+
+
+bool Groups::getOnIdle() const {
+  for (auto &name: keys())
+    if (getGroup(name).getConfig().getOnIdle())
+      return true;
+
+  return false;
+}
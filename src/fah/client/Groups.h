@@ -46,11 +46,13 @@ namespace FAH {
       const Group &getGroup(const std::string &name) const;
       Group &getGroup(const std::string &name);
       void delGroup(const std::string &name);
+      void validate(const cb::JSON::Value &configs) const;
       void configure(const cb::JSON::Value &configs);
       void triggerUpdate();
       void setState(const cb::JSON::Value &msg);
       bool getPaused() const;
       bool keepAwake() const;
+      bool getOnIdle() const;
     };
   }
 }
@@ -0,0 +1,110 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "JSONPath.h"
+
+#include <cbang/Exception.h>
+
+#include <cstdlib>
+
+using namespace FAH::Client;
+using namespace cb;
+using namespace std;
+
+
+JSONPath::JSONPath(const string &path) : path(path) {
+  size_t start = 0;
+
+  while (true) {
+    size_t end = path.find('.', start);
+    string name = path.substr(start, end == string::npos ? end : end - start);
+
+    char *numEnd = 0;
+    long index = strtol(name.c_str(), &numEnd, 10);
+    bool numeric = !name.empty() && !*numEnd && 0 <= index;
+    keys.push_back(key_t{name, numeric ? (int)index : -1});
+
+    if (end == string::npos) break;
+    start = end + 1;
+  }
+}
+
+
+JSON::ValuePtr JSONPath::find(const JSON::Value &root) const {
+  const JSON::Value *value = &root;
+  JSON::ValuePtr result;
+
+  for (auto &key: keys) {
+    if (value->isDict()) {
+      if (!value->has(key.name)) return 0;
+      result = value->get(key.name);
+
+    } else if (value->isList()) {
+      if (key.index < 0 || value->size() <= (unsigned)key.index) return 0;
+      result = value->get(key.index);
+
+    } else return 0;
+
+    value = result.get();
+  }
+
+  return result;
+}
+
+
+JSON::ValuePtr JSONPath::select(const JSON::Value &root) const {
+  auto value = find(root);
+  if (value.isNull()) THROW("Path '" << path << "' not found");
+  return value;
+}
+
+
+string JSONPath::selectString(const JSON::Value &root) const {
+  return select(root)->getString();
+}
+
+
+string JSONPath::selectString(const JSON::Value &root,
+                              const string &defaultValue) const {
+  auto value = find(root);
+  return value.isSet() ? value->getString() : defaultValue;
+}
+
+
+uint32_t JSONPath::selectU32(const JSON::Value &root,
+                             uint32_t defaultValue) const {
+  auto value = find(root);
+  return value.isSet() ? value->getU32() : defaultValue;
+}
+
+
+uint64_t JSONPath::selectU64(const JSON::Value &root,
+                             uint64_t defaultValue) const {
+  auto value = find(root);
+  return value.isSet() ? value->getU64() : defaultValue;
+}
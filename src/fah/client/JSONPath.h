@@ -0,0 +1,70 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/json/Value.h>
+
+#include <string>
+#include <vector>
+
+
+namespace FAH {
+  namespace Client {
+    /// A dotted path such as "assignment.data.credit" split into its keys
+    /// once, so lookups walk the JSON without reparsing the path.
+    class JSONPath {
+      const std::string path;
+
+      struct key_t {
+        std::string name;
+        int index; // For lists, -1 if not a number
+      };
+
+      std::vector<key_t> keys;
+
+    public:
+      JSONPath(const std::string &path);
+
+      const std::string &toString() const {return path;}
+
+      /// @return the value at this path or null if there is none
+      cb::JSON::ValuePtr find(const cb::JSON::Value &root) const;
+      bool has(const cb::JSON::Value &root) const {return find(root).isSet();}
+
+      cb::JSON::ValuePtr select(const cb::JSON::Value &root) const;
+      std::string selectString(const cb::JSON::Value &root) const;
+      std::string selectString(const cb::JSON::Value &root,
+                               const std::string &defaultValue) const;
+      uint32_t selectU32(const cb::JSON::Value &root,
+                         uint32_t defaultValue) const;
+      uint64_t selectU64(const cb::JSON::Value &root,
+                         uint64_t defaultValue) const;
+    };
+  }
+}
@@ -0,0 +1,82 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "Journal.h"
+
+#include <cbang/json/Reader.h>
+#include <cbang/net/Base64.h>
+#include <cbang/time/Time.h>
+#include <cbang/util/Random.h>
+
+using namespace FAH::Client;
+using namespace cb;
+using namespace std;
+
+
+// A new ID each run, sequence numbers from a previous run are meaningless
+Journal::Journal() : id(URLBase64().encode(Random::instance().string(12))) {}
+
+
+void Journal::use() {lastUsed = Time::now();}
+
+
+uint64_t Journal::append(const JSON::ValuePtr &batch) {
+  seq++;
+
+  // Nobody can resume, only advance the sequence
+  if (!lastUsed || lastUsed + resumeWindow < Time::now()) {
+    entries.clear();
+    bytes = 0;
+    return seq;
+  }
+
+  // Serialize, the batch references live objects which may change or be
+  // removed
+  entries.push_back(entry_t(seq, batch->toString(0, true)));
+  bytes += entries.back().second.size();
+
+  while (maxEntries < entries.size() || maxBytes < bytes) {
+    bytes -= entries.front().second.size();
+    entries.pop_front();
+  }
+
+  return seq;
+}
+
+
+bool Journal::canResume(const string &id, uint64_t since) const {
+  if (id != this->id || seq < since) return false;
+  if (since == seq) return true;
+  return !entries.empty() && entries.front().first <= since + 1;
+}
+
+
+void Journal::replay(uint64_t since, callback_t cb) const {
+  for (auto &e: entries)
+    if (since < e.first) cb(e.first, JSON::Reader::parse(e.second));
+}
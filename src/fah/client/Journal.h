@@ -0,0 +1,73 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/json/Value.h>
+
+#include <deque>
+#include <functional>
+#include <cstdint>
+
+
+namespace FAH {
+  namespace Client {
+    /// Bounded in-memory history of change batches, so remotes which
+    /// reconnect can resume from their last sequence number.  Batches are
+    /// only kept while a client which knows the journal ID is connected or
+    /// recently was.
+    class Journal {
+      const std::string id;
+      uint64_t seq = 0;
+      uint64_t lastUsed = 0;
+
+      static const unsigned maxEntries = 1e4;
+      static const uint64_t maxBytes = 1 << 22;
+      static const unsigned resumeWindow = 5 * 60; // Seconds
+
+      typedef std::pair<uint64_t, std::string> entry_t;
+      std::deque<entry_t> entries;
+      uint64_t bytes = 0;
+
+    public:
+      typedef std::function<void (uint64_t, const cb::JSON::ValuePtr &)>
+      callback_t;
+
+      Journal();
+
+      const std::string &getID() const {return id;}
+      uint64_t getSeq() const {return seq;}
+
+      /// Call while a client which can resume is connected
+      void use();
+      uint64_t append(const cb::JSON::ValuePtr &batch);
+      bool canResume(const std::string &id, uint64_t since) const;
+      void replay(uint64_t since, callback_t cb) const;
+    };
+  }
+}
@@ -0,0 +1,140 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#ifndef _WIN32
+
+#include "LocalSocket.h"
+#include "App.h"
+
+#include <cbang/Catch.h>
+#include <cbang/SStream.h>
+#include <cbang/os/SysError.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/log/Logger.h>
+#include <cbang/net/Socket.h>
+#include <cbang/net/SockAddr.h>
+#include <cbang/event/Base.h>
+#include <cbang/http/Server.h>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+
+using namespace FAH::Client;
+using namespace cb;
+using namespace std;
+
+
+LocalSocket::LocalSocket(App &app, HTTP::Server &server, const string &path) :
+  app(app), server(server), path(path) {}
+
+
+LocalSocket::~LocalSocket() {TRY_CATCH_ERROR(close());}
+
+
+void LocalSocket::open(unsigned mode) {
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+
+  if (sizeof(addr.sun_path) <= path.size())
+    THROW("Local socket path too long: " << path);
+  strcpy(addr.sun_path, path.c_str());
+
+  // Remove a stale socket left by a previous run, but nothing else
+  struct stat st;
+  if (!lstat(path.c_str(), &st)) {
+    if (!S_ISSOCK(st.st_mode)) THROW("Not a socket: " << path);
+    SystemUtilities::unlink(path);
+  }
+
+  fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) THROW("Failed to create local socket: " << SysError());
+  fcntl(fd, F_SETFD, FD_CLOEXEC);
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+  // Connections are refused until listen(), so restrict permissions between
+  // bind() and listen().  umask() is process wide and would race other
+  // threads creating files.
+  if (::bind(fd, (sockaddr *)&addr, sizeof(addr)) ||
+      chmod(path.c_str(), mode) || ::listen(fd, 128))
+    THROW("Failed to listen on " << path << ": " << SysError());
+
+  event = app.getEventBase().newEvent(
+    fd, [this] (Event::Event &, int, unsigned) {accept();},
+    Event::Event::EVENT_READ | Event::Event::EVENT_PERSIST);
+  event->add();
+
+  LOG_INFO(1, "Listening on " << path);
+}
+
+
+void LocalSocket::close() {
+  if (event.isSet()) event->del();
+  event.release();
+
+  if (fd < 0) return;
+  ::close(fd);
+  fd = -1;
+
+  SystemUtilities::unlink(path);
+}
+
+
+bool LocalSocket::isLocal(int fd) {
+  sockaddr_storage addr;
+  socklen_t len = sizeof(addr);
+  return !getsockname(fd, (sockaddr *)&addr, &len) && addr.ss_family == AF_UNIX;
+}
+
+
+void LocalSocket::accept() {
+  while (true) {
+    int conn = ::accept(fd, 0, 0);
+
+    if (conn < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        LOG_WARNING("Local socket accept failed: " << SysError());
+      if (errno != EINTR) break;
+      continue;
+    }
+
+    try {
+      fcntl(conn, F_SETFD, FD_CLOEXEC);
+      auto socket = SmartPtr(new Socket);
+      socket->adopt(conn);
+      server.accept(SockAddr(), socket, 0);
+    } CATCH_ERROR;
+  }
+}
+
+#endif // _WIN32
@@ -0,0 +1,67 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#ifndef _WIN32
+
+#include <cbang/event/Event.h>
+
+
+namespace cb {namespace HTTP {class Server;}}
+
+
+namespace FAH {
+  namespace Client {
+    class App;
+
+    /// Unix domain socket listener, access is controlled by file permissions
+    class LocalSocket {
+      App &app;
+      cb::HTTP::Server &server;
+      const std::string path;
+
+      int fd = -1;
+      cb::Event::EventPtr event;
+
+    public:
+      LocalSocket(App &app, cb::HTTP::Server &server, const std::string &path);
+      ~LocalSocket();
+
+      void open(unsigned mode);
+      void close();
+
+      static bool isLocal(int fd);
+
+    protected:
+      void accept();
+    };
+  }
+}
+
+#endif // _WIN32
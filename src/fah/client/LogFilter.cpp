@@ -0,0 +1,122 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "LogFilter.h"
+#include "App.h"
+#include "Units.h"
+#include "Unit.h"
+#include "Groups.h"
+#include "Group.h"
+
+#include <cbang/json/JSON.h>
+
+using namespace FAH::Client;
+using namespace cb;
+using namespace std;
+
+
+namespace {
+  // Severity order of cbang's short log levels
+  int rank(char level) {
+    switch (level) {
+    case 'E': return 0;
+    case 'W': return 1;
+    case 'I': return 2;
+    case 'D': return 3;
+    default:  return 4;
+    }
+  }
+
+
+  char levelOf(const string &line) {
+    // Lines look like "HH:MM:SS:I1:WU3:..."
+    if (9 < line.size() && line[2] == ':' && line[5] == ':' && line[8] == ':')
+      return line[9];
+    return 0;
+  }
+}
+
+
+LogFilter::LogFilter(App &app, const JSON::Value &filter) {
+  if (!filter.isDict()) THROW("Log filter must be a dictionary");
+
+  if (filter.hasString("level")) {
+    string name = filter.getString("level");
+    if      (name == "error")   level = 'E';
+    else if (name == "warning") level = 'W';
+    else if (name == "info")    level = 'I';
+    else if (name == "debug")   level = 'D';
+    else THROW("Invalid log level '" << name << "'");
+  }
+
+  if (filter.hasString("unit")) {
+    auto unit = app.getUnits()->findUnit(filter.getString("unit"));
+    if (unit.isNull()) THROW("Unit not found");
+    prefixes.push_back(":" + unit->getLogPrefix());
+
+  } else if (filter.hasString("group")) {
+    string group = filter.getString("group");
+    prefixes.push_back(":" + (group.empty() ? string("Default") : group) + ":");
+
+    auto groups = app.getGroups();
+    if (groups->has(group))
+      for (auto unit: groups->getGroup(group).units())
+        prefixes.push_back(":" + unit->getLogPrefix());
+  }
+
+  if (filter.hasString("regex"))
+    regex = new Regex(".*(" + filter.getString("regex") + ").*");
+}
+
+
+bool LogFilter::matches(const string &line) const {
+  if (level) {
+    char l = levelOf(line);
+    if (l && rank(level) < rank(l)) return false;
+  }
+
+  if (!prefixes.empty()) {
+    bool found = false;
+    for (auto &prefix: prefixes)
+      if (line.find(prefix) != string::npos) {found = true; break;}
+    if (!found) return false;
+  }
+  if (regex.isSet() && !regex->match(line)) return false;
+
+  return true;
+}
+
+
+JSON::ValuePtr LogFilter::filter(const JSON::Value &lines) const {
+  JSON::ValuePtr result = new JSON::List;
+
+  for (unsigned i = 0; i < lines.size(); i++)
+    if (matches(lines.getString(i))) result->append(lines.get(i));
+
+  return result;
+}
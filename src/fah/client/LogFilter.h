@@ -0,0 +1,56 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/json/Value.h>
+#include <cbang/util/Regex.h>
+
+#include <vector>
+
+
+namespace FAH {
+  namespace Client {
+    class App;
+
+    /// Selects log lines by level, unit or group prefix and regex.  A group
+    /// selects its own lines and those of the units it had when the filter
+    /// was created.
+    class LogFilter : public cb::RefCounted {
+      char level = 0; // Highest level letter to keep, 0 for all
+      std::vector<std::string> prefixes; // Any one must match
+      cb::SmartPointer<cb::Regex> regex;
+
+    public:
+      LogFilter(App &app, const cb::JSON::Value &filter);
+
+      bool matches(const std::string &line) const;
+      cb::JSON::ValuePtr filter(const cb::JSON::Value &lines) const;
+    };
+  }
+}
@@ -0,0 +1,88 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "LogQueue.h"
+
+using namespace FAH::Client;
+using namespace std;
+
+
+namespace {
+  uint64_t roundUp(unsigned x) {
+    uint64_t n = 2;
+    while (n < x) n <<= 1;
+    return n;
+  }
+}
+
+
+LogQueue::LogQueue(unsigned capacity) :
+  mask(roundUp(capacity) - 1), slots(mask + 1), head(0), dropped(0) {
+  // A slot is free for the push at position i when its seq is i
+  for (uint64_t i = 0; i < slots.size(); i++)
+    slots[i].seq.store(i, memory_order_relaxed);
+}
+
+
+bool LogQueue::push(const char *line, uint32_t length) {
+  uint64_t pos = head.load(memory_order_relaxed);
+  slot_t *slot;
+
+  while (true) {
+    slot = &slots[pos & mask];
+    int64_t diff = (int64_t)(slot->seq.load(memory_order_acquire) - pos);
+
+    if (!diff) {
+      if (head.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+        break;
+
+    } else if (diff < 0) {
+      dropped.fetch_add(1, memory_order_relaxed);
+      return false; // Full
+
+    } else pos = head.load(memory_order_relaxed);
+  }
+
+  // Reuses the slot's buffer once lines of this size have been seen
+  slot->line.assign(line, length);
+  slot->seq.store(pos + 1, memory_order_release);
+
+  return true;
+}
+
+
+bool LogQueue::pop(string &line) {
+  slot_t &slot = slots[tail & mask];
+  if (slot.seq.load(memory_order_acquire) != tail + 1) return false;
+
+  line.assign(slot.line);
+  slot.seq.store(tail + mask + 1, memory_order_release);
+  tail++;
+
+  return true;
+}
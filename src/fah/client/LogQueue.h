@@ -0,0 +1,65 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+
+namespace FAH {
+  namespace Client {
+    /// Bounded lock-free queue of log lines.  Any number of threads may push
+    /// but only one may pop.  Lines pushed while the queue is full are
+    /// dropped and counted.
+    class LogQueue {
+      struct slot_t {
+        std::atomic<uint64_t> seq;
+        std::string line;
+      };
+
+      const uint64_t mask;
+      std::vector<slot_t> slots;
+      std::atomic<uint64_t> head;
+      uint64_t tail = 0;
+      std::atomic<uint64_t> dropped;
+
+    public:
+      /// @param capacity is rounded up to a power of two
+      LogQueue(unsigned capacity = 1 << 14);
+
+      bool push(const char *line, uint32_t length);
+      bool pop(std::string &line);
+
+      /// @return the number of lines dropped since the last call
+      uint64_t takeDropped() {return dropped.exchange(0);}
+    };
+  }
+}
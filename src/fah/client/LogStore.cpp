@@ -0,0 +1,355 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "LogStore.h"
+#include "LogFilter.h"
+#include "App.h"
+#include "Groups.h"
+#include "Remote.h"
+#include "WorkerThread.h"
+
+#include <cbang/String.h>
+#include <cbang/Catch.h>
+#include <cbang/comp/Press.h>
+#include <cbang/json/JSON.h>
+#include <cbang/log/Logger.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/time/Time.h>
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <cstdio>
+#include <cinttypes>
+
+using namespace FAH::Client;
+using namespace cb;
+using namespace std;
+
+
+LogStore::LogStore(App &app) :
+  app(app), flushEvent(app.getEventBase().newEvent([this] {flush();}, 0)),
+  writer(app.getEventBase()) {}
+
+
+void LogStore::init(const string &dir, uint32_t segmentBytes, unsigned days) {
+  this->dir = dir;
+  this->segmentBytes = segmentBytes;
+  this->days = days;
+
+  SystemUtilities::ensureDirectory(dir);
+  prune();
+}
+
+
+void LogStore::flush() {
+  if (data.empty()) return;
+  flushEvent->del();
+
+  string key    = String::printf("%012" PRIu64 "-%" PRIu64, start, first);
+  string path   = dir + "/" + key + ".gz";
+  auto segment  = describe();
+  auto contents = make_shared<const string>(move(data));
+
+  // Index now, segments which fail to write are removed again
+  try {
+    app.getDB("log_segments", true).set(key, segment->toString());
+    for (auto &tag: tags) addTag(tag, key);
+  } CATCH_ERROR;
+
+  writing[key] = contents;
+  writer.submit(
+    [contents, path] {
+      *SystemUtilities::oopen(path) << Press("gzip").compress(*contents);
+    },
+    [this, key, segment] (const string &error) {
+      writing.erase(key);
+      if (error.empty()) return;
+      LOG_ERROR("Failed to write log segment " << key << ": " << error);
+      remove(key, *segment);
+    });
+
+  data.clear();
+  tags.clear();
+  lines = 0;
+
+  prune();
+}
+
+
+void LogStore::shutdown() {
+  flush();
+  writer.shutdown(true);
+}
+
+
+void LogStore::query(const JSON::Value &query,
+                     const SmartPointer<LogFilter> &filter, done_t done) {
+  if (dir.empty()) return done(new JSON::List); // Disabled
+
+  uint64_t from  = query.getU64("from", 0);
+  uint64_t to    = query.getU64("to", Time::now());
+  string tag     = query.getString("tag", "");
+  unsigned limit = min(query.getU32("limit", maxLogQuery), maxLogQuery);
+
+  // Candidate segments, from the tag index if possible
+  auto &db = app.getDB("log_segments", true);
+  map<string, JSON::ValuePtr> segments;
+
+  if (!tag.empty()) {
+    std::set<string> keys;
+    app.getDB("log_tags").foreach(
+      [&keys, &tag] (const string &row, const string &) {
+        size_t space = row.rfind(' ');
+        if (space != string::npos && row.substr(0, space) == tag)
+          keys.insert(row.substr(space + 1));
+      });
+
+    for (auto &key: keys)
+      if (db.has(key))
+        TRY_CATCH_ERROR(segments[key] = JSON::parse(db.getString(key)));
+
+  } else db.foreach([&segments] (const string &key, const string &data) {
+      TRY_CATCH_ERROR(segments[key] = JSON::parse(data));
+    });
+
+  // Newest first, starting with lines not yet written
+  struct job_t {
+    JSON::ValuePtr segment;
+    string path;
+    shared_ptr<const string> data;
+  };
+
+  vector<job_t> jobs;
+
+  if (!data.empty() && from <= end && start <= to &&
+      (tag.empty() || tags.count(tag)))
+    jobs.push_back({describe(), "", make_shared<const string>(data)});
+
+  for (auto it = segments.rbegin(); it != segments.rend(); it++) {
+    auto &segment = *it->second;
+    if (segment.getU64("end") < from || to < segment.getU64("start")) continue;
+
+    job_t job = {it->second, dir + "/" + it->first + ".gz", nullptr};
+    auto w = writing.find(it->first);
+    if (w != writing.end()) job.data = w->second; // Still being written
+    jobs.push_back(job);
+  }
+
+  // Decompressing days of segments would stall the event loop
+  JSON::ValuePtr results = new JSON::List;
+
+  app.getWorker().submit(
+    [jobs, tag, filter, from, to, limit, results] {
+      unsigned remaining = limit;
+
+      for (auto &job: jobs) {
+        try {
+          string data = job.data ? *job.data :
+            Press("gzip").decompress(SystemUtilities::read(job.path));
+          remaining -= select(*job.segment, data, tag, filter.get(), from,
+                              to, remaining, *results);
+        } CATCH_ERROR;
+
+        if (!remaining) break;
+      }
+    },
+    [done, results] (const string &error) {
+      if (!error.empty()) LOG_ERROR("Log query failed: " << error);
+
+      // Segments were read newest first, return them oldest first
+      JSON::ValuePtr ordered = new JSON::List;
+      for (unsigned i = results->size(); i; i--)
+        ordered->append(results->get(i - 1));
+
+      done(ordered);
+    });
+}
+
+
+void LogStore::logUpdate(const JSON::ValuePtr &lines, uint64_t last) {
+  for (unsigned i = 0; i < lines->size(); i++) {
+    const string &line = lines->getString(i);
+
+    if (data.empty()) {
+      start = Time::now();
+      first = last - lines->size() + i + 1;
+      flushEvent->add(maxSegmentAge);
+    }
+
+    data.append(line);
+    data.push_back('\n');
+    end = Time::now();
+    this->lines++;
+
+    string tag = getTag(line);
+    if (!tag.empty()) tags.insert(tag);
+
+    if (segmentBytes <= data.size()) flush();
+  }
+}
+
+
+string LogStore::parseTag(const string &line) {
+  // Lines look like "HH:MM:SS:I1:WU3:..." or "HH:MM:SS:I1:<group>:..."
+  if (line.size() < 10 || line[2] != ':' || line[5] != ':' || line[8] != ':')
+    return "";
+
+  size_t begin = line.find(':', 9);
+  if (begin == string::npos) return "";
+  size_t end = line.find(':', ++begin);
+  if (end == string::npos) return "";
+
+  return line.substr(begin, end - begin);
+}
+
+
+string LogStore::getTag(const string &line) const {
+  string tag = parseTag(line);
+  if (tag.empty()) return "";
+
+  if (2 < tag.size() && tag[0] == 'W' && tag[1] == 'U' &&
+      tag.find_first_not_of("0123456789", 2) == string::npos) return tag;
+
+  auto groups = app.getGroups();
+  if (tag == "Default" || (groups.isSet() && groups->has(tag))) return tag;
+
+  return "";
+}
+
+
+void LogStore::addTag(const string &tag, const string &key) {
+  // One row per tag and segment, segment keys contain no spaces
+  app.getDB("log_tags").set(tag + " " + key, "");
+}
+
+
+void LogStore::removeTag(const string &tag, const string &key) {
+  auto &db = app.getDB("log_tags");
+  string row = tag + " " + key;
+  if (db.has(row)) db.unset(row);
+}
+
+
+void LogStore::prune() {
+  if (!days) return;
+
+  uint64_t cutoff = Time::now() - (uint64_t)days * Time::SEC_PER_DAY;
+  auto &db = app.getDB("log_segments", true);
+  map<string, JSON::ValuePtr> expired;
+
+  db.foreach([&expired, cutoff] (const string &key, const string &data) {
+      try {
+        auto segment = JSON::parse(data);
+        if (segment->getU64("end") < cutoff) expired[key] = segment;
+      } CATCH_ERROR;
+    });
+
+  for (auto &p: expired) {
+    LOG_DEBUG(3, "Removing log segment " << p.first);
+    remove(p.first, *p.second);
+  }
+}
+
+
+void LogStore::remove(const string &key, const JSON::Value &segment) {
+  string path = dir + "/" + key + ".gz";
+  if (SystemUtilities::exists(path))
+    TRY_CATCH_WARNING(SystemUtilities::unlink(path));
+
+  if (segment.hasList("tags"))
+    for (auto &tag: *segment.get("tags")) removeTag(tag->getString(), key);
+
+  app.getDB("log_segments", true).unset(key);
+}
+
+
+JSON::ValuePtr LogStore::describe() const {
+  JSON::ValuePtr segment = new JSON::Dict;
+  segment->insert("start", start);
+  segment->insert("end",   end);
+  segment->insert("first", first);
+  segment->insert("lines", lines);
+  segment->insert("bytes", data.size());
+
+  JSON::ValuePtr tags = new JSON::List;
+  for (auto &tag: this->tags) tags->append(tag);
+  segment->insert("tags", tags);
+
+  return segment;
+}
+
+
+unsigned LogStore::select(const JSON::Value &segment, const string &data,
+                          const string &tag, const LogFilter *filter,
+                          uint64_t from, uint64_t to, unsigned limit,
+                          JSON::Value &results) {
+  // Lines carry UTC times of day, dated from the segment's start
+  uint64_t start = segment.getU64("start");
+  uint64_t day   = start - start % Time::SEC_PER_DAY;
+  uint64_t time  = start;
+
+  deque<string> lines; // The newest matching lines
+  size_t offset = 0;
+
+  while (offset < data.size()) {
+    size_t eol = data.find('\n', offset);
+    if (eol == string::npos) eol = data.size();
+
+    string line = data.substr(offset, eol - offset);
+    offset = eol + 1;
+
+    unsigned h, m, s;
+    if (sscanf(line.c_str(), "%2u:%2u:%2u:", &h, &m, &s) == 3) {
+      uint64_t t = day + h * 3600 + m * 60 + s;
+      while (t + 3600 < time) t += Time::SEC_PER_DAY; // Past midnight
+      time = t;
+    }
+
+    if (time < from) continue;
+    if (to < time) break;
+    if (!tag.empty() && parseTag(line) != tag) continue;
+    if (filter && !filter->matches(line)) continue;
+
+    lines.push_back(line);
+    if (limit < lines.size()) lines.pop_front();
+  }
+
+  if (lines.empty()) return 0;
+
+  JSON::ValuePtr list = new JSON::List;
+  for (auto &line: lines) list->append(line);
+
+  JSON::ValuePtr result = new JSON::Dict;
+  result->insert("start", segment.getU64("start"));
+  result->insert("end",   segment.getU64("end"));
+  result->insert("lines", list);
+  results.append(result);
+
+  return list->size();
+}
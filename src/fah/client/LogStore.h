@@ -0,0 +1,106 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "LogTracker.h"
+#include "WorkerThread.h"
+
+#include <cbang/json/Value.h>
+#include <cbang/event/Event.h>
+
+#include <set>
+#include <map>
+#include <memory>
+#include <functional>
+#include <string>
+#include <cstdint>
+
+
+namespace FAH {
+  namespace Client {
+    class App;
+    class LogFilter;
+
+    /// Keeps log lines on disk in gzipped segments.  Segments are indexed in
+    /// the DB by time and by the WU and group tags of their lines, so queries
+    /// only read the segments which can match.
+    class LogStore : public LogTracker::Listener, public cb::RefCounted {
+      App &app;
+      std::string dir;
+      uint32_t segmentBytes = 0;
+      unsigned days = 0;
+      cb::Event::EventPtr flushEvent;
+
+      // Segments are compressed and written on their own thread
+      WorkerThread writer;
+      std::map<std::string, std::shared_ptr<const std::string>> writing;
+
+      // The segment being written
+      std::string data;
+      std::set<std::string> tags;
+      uint64_t start = 0;
+      uint64_t end   = 0;
+      uint64_t first = 0;
+      unsigned lines = 0;
+
+      static const unsigned maxSegmentAge = 60 * 60;
+
+    public:
+      typedef std::function<void (const cb::JSON::ValuePtr &results)> done_t;
+
+      LogStore(App &app);
+
+      void init(const std::string &dir, uint32_t segmentBytes, unsigned days);
+      void flush();
+      void shutdown();
+
+      /// Query by "from" and "to" times, "tag" and "limit".  Segments are
+      /// read on the worker thread, newest first, then @param done is
+      /// called on the event loop with the newest matching lines.
+      void query(const cb::JSON::Value &query,
+                 const cb::SmartPointer<LogFilter> &filter, done_t done);
+
+      // From LogTracker::Listener
+      void logUpdate(const cb::JSON::ValuePtr &lines, uint64_t last) override;
+
+    protected:
+      static std::string parseTag(const std::string &line);
+      std::string getTag(const std::string &line) const;
+      void addTag(const std::string &tag, const std::string &key);
+      void removeTag(const std::string &tag, const std::string &key);
+      void prune();
+      void remove(const std::string &key, const cb::JSON::Value &segment);
+      cb::JSON::ValuePtr describe() const;
+      static unsigned select(
+        const cb::JSON::Value &segment, const std::string &data,
+        const std::string &tag, const LogFilter *filter, uint64_t from,
+        uint64_t to, unsigned limit, cb::JSON::Value &results);
+    };
+  }
+}
@@ -27,35 +27,58 @@
 \******************************************************************************/
 
 #include "LogTracker.h"
+#include "LogFilter.h"
 
+#include <cbang/Catch.h>
 #include <cbang/log/Logger.h>
-#include <cbang/thread/SmartLock.h>
+
+#include <cstring>
 
 using namespace std;
 using namespace cb;
 using namespace FAH::Client;
 
 
-LogTracker::LogTracker(Event::Base &base) :
-  event(base.newEvent([this] {update();}, 0)) {}
+LogTracker::LogTracker(Event::Base &base, uint32_t bytes) :
+  event(base.newEvent([this] {update();}, 0)), writer(event), arena(bytes) {}
+
+
+LogTracker::~LogTracker() {TRY_CATCH_ERROR(writer.shutdown());}
+
+
+void LogTracker::setBudget(uint32_t bytes) {
+  if (bytes == arena.size()) return;
+
+  vector<char> old(bytes);
+  old.swap(arena);
+  deque<entry_t> lines;
+  lines.swap(entries);
+  tail = 0;
+
+  // Keep as many of the newest lines as fit
+  unsigned keep = lines.size();
+  uint64_t size = 0;
+  while (keep && size + lines[keep - 1].length <= bytes)
+    size += lines[--keep].length;
+
+  for (unsigned i = keep; i < lines.size(); i++)
+    append(lines[i].index, &old[lines[i].offset], lines[i].length);
+}
+
+
+void LogTracker::openLog(const string &filename, const string &rotateDir,
+                         unsigned rotateMax, double rotatePeriod) {
+  writer.init(filename, rotateDir, rotateMax, rotatePeriod);
+}
 
 
 void LogTracker::add(const cb::SmartPointer<Listener> &listener,
                      uint64_t lastLine) {
   listeners.insert(listener);
 
-  auto newLines = SmartPtr(new JSON::List);
-  {
-    SmartLock lock(&Logger::instance());
-
-    for (unsigned ptr = head; ptr != last; adv(ptr))
-      if (lastLine < lines[ptr].first) {
-        newLines->append(lines[ptr].second);
-        lastLine = lines[ptr].first;
-      }
-  }
-
-  if (!newLines->empty()) listener->logUpdate(newLines, lastLine);
+  uint64_t last = lastLine;
+  auto newLines = read(lastLine, last);
+  if (newLines->size()) listener->logUpdate(newLines, last);
 }
 
 
@@ -65,30 +88,107 @@ void LogTracker::remove(const cb::SmartPointer<Listener> &listener) {
 
 
 void LogTracker::writeln(const char *s) {
-  lines[tail] = entry_t(index++, s);
-  adv(tail);
-  if (tail == head) adv(head);
-  if (tail == last) adv(last);
-  if (!event->isPending()) event->add(0.25);
+  // Called from any thread with the Logger lock held
+  writer.push(s, strlen(s));
 }
 
 
-void LogTracker::update() {
-  uint64_t lastIndex = 0;
-  auto newLines = SmartPtr(new JSON::List);
-  {
-    SmartLock lock(&Logger::instance());
-
-    for (; last != tail; adv(last)) {
-      newLines->append(lines[last].second);
-      lastIndex = lines[last].first;
-    }
+void LogTracker::append(uint64_t index, const char *s, uint32_t length) {
+  if (arena.empty()) return;
+  if (arena.size() < length) length = arena.size();
+
+  // Lines are never split, wrap to the start if it doesn't fit
+  if (arena.size() < tail + length) tail = 0;
+
+  // Drop the oldest lines which would be overwritten
+  while (!entries.empty()) {
+    auto &e = entries.front();
+    if (e.offset + e.length <= tail || tail + length <= e.offset) break;
+    entries.pop_front();
   }
 
-  if (newLines->size())
-    for (auto &l: listeners)
-      l->logUpdate(newLines, lastIndex);
+  memcpy(&arena[tail], s, length);
+  entries.push_back(entry_t{index, tail, length});
+  tail += length;
 }
 
 
-void LogTracker::adv(unsigned &ptr) {if (++ptr == maxLines) ptr = 0;}
+uint64_t LogTracker::copy(uint64_t first, uint64_t last,
+                          vector<uint32_t> &lengths, string &bytes) {
+  if (entries.empty() || last < first) return 0;
+
+  // Line indices are consecutive
+  uint64_t front = entries.front().index;
+  uint64_t back  = entries.back().index;
+  if (first < front) first = front;
+  if (back < last) last = back;
+
+  for (uint64_t i = first; i <= last; i++) {
+    auto &e = entries[i - front];
+    lengths.push_back(e.length);
+    bytes.append(&arena[e.offset], e.length);
+  }
+
+  return first;
+}
+
+
+JSON::ValuePtr LogTracker::read(uint64_t after, uint64_t &last) {
+  vector<uint32_t> lengths;
+  string bytes;
+  uint64_t first = copy(after + 1, UINT64_MAX, lengths, bytes);
+
+  auto list = SmartPtr(new JSON::List);
+  uint32_t offset = 0;
+
+  for (auto length: lengths) {
+    list->append(bytes.substr(offset, length));
+    offset += length;
+  }
+
+  if (lengths.size()) last = first + lengths.size() - 1;
+
+  return list;
+}
+
+
+JSON::ValuePtr LogTracker::query(uint64_t first, uint64_t last,
+                                 unsigned limit, const LogFilter *filter) {
+  vector<uint32_t> lengths;
+  string bytes;
+  first = copy(first, last, lengths, bytes);
+
+  auto list = SmartPtr(new JSON::List);
+  uint32_t offset = 0;
+
+  for (unsigned i = 0; i < lengths.size() && list->size() < limit; i++) {
+    string line = bytes.substr(offset, lengths[i]);
+    offset += lengths[i];
+
+    if (filter && !filter->matches(line)) continue;
+
+    auto entry = SmartPtr(new JSON::List);
+    entry->append(first + i);
+    entry->append(line);
+    list->append(entry);
+  }
+
+  return list;
+}
+
+
+void LogTracker::update() {
+  vector<string> lines;
+  uint64_t dropped = writer.take(lines);
+  for (auto &line: lines) append(index++, line.data(), line.size());
+
+  if (dropped) LOG_WARNING("Log queue full, dropped " << dropped << " lines");
+
+  uint64_t last = sent;
+  auto newLines = read(sent, last);
+  if (!newLines->size()) return;
+
+  sent = last;
+  for (auto &l: listeners)
+    l->logUpdate(newLines, last);
+}
@@ -28,11 +28,13 @@
 
 #pragma once
 
+#include "LogWriter.h"
+
 #include <cbang/log/LogLineListener.h>
 #include <cbang/event/Event.h>
 #include <cbang/json/List.h>
 
-#include <list>
+#include <deque>
 #include <vector>
 #include <set>
 #include <cstdint>
@@ -40,6 +42,8 @@
 
 namespace FAH {
   namespace Client {
+    class LogFilter;
+
     class LogTracker : public cb::LogLineListener {
     public:
       class Listener {
@@ -53,26 +57,54 @@ namespace FAH {
       cb::Event::EventPtr event;
       std::set<cb::SmartPointer<Listener>> listeners;
 
-      static const unsigned maxLines = 1e5;
-      typedef std::pair<uint64_t, std::string> entry_t;
-      entry_t lines[maxLines];
-      unsigned head  = 0;
-      unsigned tail  = 0;
-      unsigned last  = 0;
-      uint64_t index = 0;
+      // Lines are queued by the logging threads, written to the log file by
+      // the writer thread and then moved to the arena on the event loop, so
+      // logging never waits on file I/O or the event loop
+      LogWriter writer;
+
+      // Log lines are kept back to back in a circular byte arena
+      struct entry_t {
+        uint64_t index;
+        uint32_t offset;
+        uint32_t length;
+      };
+
+      std::vector<char>   arena;
+      std::deque<entry_t> entries;
+      uint32_t tail  = 0;
+      uint64_t index = 1; // Index of the next line
+      uint64_t sent  = 0; // Index of the last line sent to listeners
 
     public:
-      LogTracker(cb::Event::Base &base);
+      LogTracker(cb::Event::Base &base, uint32_t bytes = 1e7);
+      ~LogTracker();
+
+      void setBudget(uint32_t bytes);
+
+      /// Starts the writer thread, see LogWriter::init()
+      void openLog(const std::string &filename, const std::string &rotateDir,
+                   unsigned rotateMax, double rotatePeriod);
+
+      /// @return the index of the latest line
+      uint64_t getLast() const {return index - 1;}
 
       void add(const cb::SmartPointer<Listener> &listener, uint64_t last);
       void remove(const cb::SmartPointer<Listener> &listener);
 
+      /// @return [index, line] pairs for lines from @param first to
+      /// @param last which pass @param filter, at most @param limit of them
+      cb::JSON::ValuePtr query(uint64_t first, uint64_t last, unsigned limit,
+                               const LogFilter *filter = 0);
+
     protected:
       // From cb::LogLineListener
       void writeln(const char *s) override;
 
+      void append(uint64_t index, const char *s, uint32_t length);
+      uint64_t copy(uint64_t first, uint64_t last,
+                    std::vector<uint32_t> &lengths, std::string &bytes);
+      cb::JSON::ValuePtr read(uint64_t after, uint64_t &last);
       void update();
-      void adv(unsigned &ptr);
     };
   }
 }
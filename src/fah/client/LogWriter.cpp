@@ -0,0 +1,166 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "LogWriter.h"
+
+#include <cbang/Catch.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/thread/SmartLock.h>
+#include <cbang/time/Timer.h>
+
+#include <fstream>
+#include <iterator>
+
+using namespace FAH::Client;
+using namespace cb;
+using namespace std;
+
+
+namespace {
+  const double   writePeriod = 0.25; // Seconds between writes
+  const double   retryDelay  = 60;   // Seconds before reopening after errors
+  const unsigned maxReady    = 1 << 16;
+}
+
+
+LogWriter::LogWriter(const Event::EventPtr &event) : event(event) {}
+LogWriter::~LogWriter() {TRY_CATCH_ERROR(shutdown());}
+
+
+void LogWriter::init(const string &filename, const string &rotateDir,
+                     unsigned rotateMax, double rotatePeriod) {
+  if (isRunning()) return;
+
+  this->filename     = filename;
+  this->rotateDir    = rotateDir;
+  this->rotateMax    = rotateMax;
+  this->rotatePeriod = rotatePeriod;
+
+  if (!filename.empty()) open(true);
+  start();
+}
+
+
+void LogWriter::shutdown() {
+  if (!isRunning()) return;
+  stop();
+  join();
+}
+
+
+uint64_t LogWriter::take(vector<string> &lines) {
+  SmartLock lock(this);
+  lines.swap(ready);
+  ready.clear();
+
+  uint64_t count = dropped;
+  dropped = 0;
+  return count;
+}
+
+
+void LogWriter::open(bool rotate) {
+  stream.release();
+
+  string dir = SystemUtilities::dirname(filename);
+  if (!dir.empty()) SystemUtilities::ensureDirectory(dir);
+
+  if (rotate) {
+    SystemUtilities::rotate(filename, rotateDir, rotateMax);
+    stream = SystemUtilities::oopen(filename);
+    opened = Timer::now();
+
+  } else { // Keep what was written before the error
+    stream = new ofstream(filename.c_str(), ios::out | ios::app);
+    if (stream->fail()) THROW("Open failed");
+  }
+}
+
+
+void LogWriter::drain() {
+  vector<string> lines;
+
+  while (true) {
+    lines.emplace_back();
+    if (!queue.pop(lines.back())) {lines.pop_back(); break;}
+  }
+
+  uint64_t lost = queue.takeDropped();
+  if (lines.empty() && !lost) return;
+
+  if (!filename.empty())
+    try {
+      double now = Timer::now();
+
+      if (stream.isNull()) {
+        if (failed + retryDelay <= now) open(false);
+      } else if (rotatePeriod && opened + rotatePeriod <= now) open(true);
+
+      if (stream.isSet()) {
+        for (auto &line: lines)
+          *stream << line << '\n';
+        stream->flush();
+
+        if (stream->fail()) THROW("Write failed");
+      }
+
+    } catch (const Exception &e) {
+      // Logging here would only queue more lines for this file
+      cerr << "Failed to write " << filename << ": " << e.getMessage() << endl;
+      stream.release();
+      failed = Timer::now();
+    }
+
+  {
+    SmartLock lock(this);
+
+    // The event loop may be stalled, drop lines rather than grow
+    size_t room = ready.size() < maxReady ? maxReady - ready.size() : 0;
+    if (room < lines.size()) {
+      lost += lines.size() - room;
+      lines.resize(room);
+    }
+
+    ready.insert(ready.end(), make_move_iterator(lines.begin()),
+                 make_move_iterator(lines.end()));
+    dropped += lost;
+  }
+
+  event->activate();
+}
+
+
+void LogWriter::run() {
+  while (!shouldShutdown()) {
+    drain();
+    Timer::sleep(writePeriod);
+  }
+
+  drain();
+  stream.release();
+}
@@ -0,0 +1,88 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "LogQueue.h"
+
+#include <cbang/thread/Thread.h>
+#include <cbang/thread/Mutex.h>
+#include <cbang/event/Event.h>
+#include <cbang/SmartPointer.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+namespace FAH {
+  namespace Client {
+    /// Drains the log queue on its own thread, writes the log file and
+    /// hands the lines on to the event loop.  Rotates the log file like
+    /// cbang's Logger.
+    class LogWriter : public cb::Thread, public cb::Mutex {
+      cb::Event::EventPtr event; // Activated when lines are ready
+      LogQueue queue;
+
+      std::string filename;
+      std::string rotateDir;
+      unsigned rotateMax = 0;
+      double rotatePeriod = 0;
+      double opened = 0;
+      double failed = 0;
+      cb::SmartPointer<std::ostream> stream;
+
+      // Written lines not yet taken by the event loop, at most maxReady
+      std::vector<std::string> ready;
+      uint64_t dropped = 0;
+
+    public:
+      LogWriter(const cb::Event::EventPtr &event);
+      ~LogWriter();
+
+      /// Called from any thread, never waits
+      void push(const char *line, uint32_t length) {queue.push(line, length);}
+
+      /// Starts writing, @param filename may be empty to only pass lines on
+      void init(const std::string &filename, const std::string &rotateDir,
+                unsigned rotateMax, double rotatePeriod);
+      /// Writes any queued lines then stops
+      void shutdown();
+
+      /// @return lines written since the last call and the count dropped
+      uint64_t take(std::vector<std::string> &lines);
+
+    protected:
+      void open(bool rotate);
+      void drain();
+
+      // From cb::Thread
+      void run() override;
+    };
+  }
+}
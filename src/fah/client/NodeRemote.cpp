@@ -28,32 +28,84 @@
 
 #include "NodeRemote.h"
 #include "Account.h"
+#include "App.h"
 
+#include <cbang/Catch.h>
 #include <cbang/log/Logger.h>
+#include <cbang/event/Base.h>
 
 using namespace std;
 using namespace cb;
 using namespace FAH::Client;
 
 
+namespace {
+  const double   flushDelay = 0.25; // seconds
+  const unsigned maxQueued  = 256;
+}
+
+
 NodeRemote::NodeRemote(
   App &app, Account &account, const string &sid) :
-  Remote(app), account(account), sid(sid) {}
+  Remote(app), account(account), sid(sid),
+  flushEvent(app.getEventBase().newEvent([this] {flush();}, 0)) {}
 
 
 string NodeRemote::getName() const {return sid;}
 
 
+void NodeRemote::flush() {
+  flushEvent->del();
+  if (queue.isNull()) return;
+
+  JSON::Dict payload;
+
+  payload.insert("session", sid);
+  payload.insert("batch",   queue);
+  queue.release();
+
+  account.sendEncrypted(payload, sid, &compression);
+}
+
+
 void NodeRemote::send(const JSON::ValuePtr &msg) {
   LOG_DEBUG(5, "Sending " << *msg << " to " << getName());
 
+  if (batching) {
+    // Collect messages for a short time and send them in one envelope.
+    // Most messages are lists of scalars which do not change once sent.
+    // Nested values may be live state which changes before the flush.
+    bool nested = false;
+    if (msg->isList() || msg->isDict())
+      for (unsigned i = 0; i < msg->size() && !nested; i++)
+        nested = msg->get(i)->isList() || msg->get(i)->isDict();
+
+    if (queue.isNull()) queue = new JSON::List;
+    queue->append(nested ? msg->copy(true) : msg);
+
+    if (maxQueued <= queue->size()) flush();
+    else if (!flushEvent->isPending()) flushEvent->add(flushDelay);
+    return;
+  }
+
   JSON::Dict payload;
 
   payload.insert("session", sid);
   payload.insert("content", msg);
 
-  account.sendEncrypted(payload, sid);
+  account.sendEncrypted(payload, sid, &compression);
 }
 
 
-void NodeRemote::close() {onClose();}
+void NodeRemote::close() {
+  TRY_CATCH_ERROR(flush()); // Send the last changes before disconnecting
+
+  auto &c = compression;
+  if (c.messages)
+    LOG_DEBUG(3, "Session " << sid << " sent " << c.messages << " messages, "
+              << c.compressed << " compressed with " << c.codec << ", "
+              << c.bytesIn << " -> " << c.bytesOut << " bytes in "
+              << c.seconds << " sec");
+
+  onClose();
+}
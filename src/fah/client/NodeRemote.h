@@ -29,21 +29,36 @@
 #pragma once
 
 #include "Remote.h"
+#include "Account.h"
+
+#include <cbang/event/Event.h>
 
 
 namespace FAH {
   namespace Client {
-    class Account;
-
     class NodeRemote : public Remote {
       Account &account;
       const std::string sid;
 
+      // Messages queued for the next batched envelope
+      bool batching = false;
+      cb::JSON::ValuePtr queue;
+      cb::Event::EventPtr flushEvent;
+
+      Account::compression_t compression;
+
     public:
       NodeRemote(App &app, Account &account, const std::string &sid);
 
       const std::string &getSessionID() const {return sid;}
 
+      void setBatching(bool batching) {this->batching = batching;}
+      void setCompression(const std::string &codec)
+        {compression.codec = codec;}
+      const Account::compression_t &getCompression() const
+        {return compression;}
+      void flush();
+
       // From Remote
       std::string getName() const override;
       void send(const cb::JSON::ValuePtr &msg) override;
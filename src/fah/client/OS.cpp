@@ -50,7 +50,7 @@ using namespace std;
 
 OS::OS(App &app) : app(app), paused(false), active(false), failure(false),
   onBattery(false), state(STATE_NULL),
-  event(app.getEventBase().newEvent([this] {update();})) {event->add(2);}
+  event(app.getEventBase().newEvent([this] {update();}, 0)) {event->add(2);}
 
 
 OS::~OS() {}
@@ -113,4 +113,8 @@ void OS::update() {
 
   // Update application info
   app.get("info")->insertBoolean("on_battery", onBattery);
+
+  // Idle detection must be responsive, otherwise only battery state and
+  // keep awake, which expires after 30s, need checking
+  event->add(app.getOnIdle() ? 2 : 10);
 }
\ No newline at end of file
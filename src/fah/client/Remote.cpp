@@ -35,6 +35,9 @@
 #include "Unit.h"
 #include "Config.h"
 #include "Group.h"
+#include "Journal.h"
+#include "LogStore.h"
+#include "Batch.h"
 
 #include <cbang/Catch.h>
 #include <cbang/log/Logger.h>
@@ -46,7 +49,38 @@ using namespace std;
 
 
 Remote::Remote(App &app) : app(app) {}
-Remote::~Remote() {}
+Remote::~Remote() {*alive = false;}
+
+
+void Remote::setResume(const string &journal, uint64_t since) {
+  journaled     = true;
+  resumeJournal = journal;
+  resumeSeq     = since;
+}
+
+
+void Remote::setViz(const string &unitID, unsigned frame,
+                    const SmartPointer<VizStream> &stream) {
+  if (unitID != vizUnitID) {
+    auto &units = *app.getUnits();
+
+    if (!vizUnitID.empty()) {
+      auto unit = units.findUnit(vizUnitID);
+      if (unit.isSet()) unit->removeViewer();
+    }
+
+    vizUnitID = unitID;
+
+    if (!unitID.empty()) {
+      auto unit = units.findUnit(unitID);
+      if (unit.isSet()) unit->addViewer();
+    }
+  }
+
+  vizFrame  = frame;
+  vizStream = stream;
+  sendViz();
+}
 
 
 void Remote::sendViz() {
@@ -58,10 +92,11 @@ void Remote::sendViz() {
     return;
   }
 
-  auto topology = unit->getTopology();
-  auto frames   = unit->getFrames();
+  auto viewer = unit->getViewer();
+  if (viewer.isNull()) return;
 
-  if (topology.isNull()) return;
+  auto &topology = viewer->getTopology();
+  if (vizStream.isSet()) vizStream->setTopology(topology);
 
   // Send topology
   if (!vizFrame) {
@@ -69,18 +104,30 @@ void Remote::sendViz() {
     changes->append("viz");
     changes->append(vizUnitID);
     changes->append("topology");
-    changes->append(topology);
+    changes->append(vizStream.isSet() ? vizStream->encodeTopology(topology) :
+                    viewer->getTopologyJSON());
     sendChanges(changes);
   }
 
   // Send frames
-  while (vizFrame < frames.size()) {
+  while (vizFrame < viewer->getFrameCount()) {
+    // Limit the frame rate
+    double delay = vizStream.isSet() ? vizStream->getDelay() : 0;
+    if (delay) {
+      if (vizEvent.isNull())
+        vizEvent = app.getEventBase().newEvent([this] {sendViz();}, 0);
+      if (!vizEvent->isPending()) vizEvent->add(delay);
+      break;
+    }
+
     SmartPointer<JSON::List> changes = new JSON::List;
     changes->append("viz");
     changes->append(vizUnitID);
     changes->append("frames");
     changes->append(vizFrame);
-    changes->append(frames[vizFrame]);
+    changes->append(vizStream.isSet() ?
+                    vizStream->encodeFrame(viewer->getFrame(vizFrame)) :
+                    viewer->getFrameJSON(vizFrame));
     sendChanges(changes);
     vizFrame++;
   }
@@ -121,10 +168,28 @@ void Remote::logWU(const Unit &wu) {
 void Remote::sendChanges(const JSON::ValuePtr &changes) {
   try {
     send(changes);
+    checkViz(*changes);
 
-    // Check for viz frame changes: ["units", <unit index>, "frames", #]
-    if (changes->size() == 4 && changes->getString(0) == "units" &&
-        changes->getString(2) == "frames") sendViz();
+  } catch (const Exception &e) {
+    close();
+    LOG_WARNING("Lost connection to remote: " << e);
+  }
+}
+
+
+void Remote::sendBatch(uint64_t seq, const JSON::ValuePtr &batch) {
+  if (!journaled) {
+    for (auto changes: *batch) sendChanges(changes);
+    return;
+  }
+
+  try {
+    JSON::ValuePtr msg = new JSON::Dict;
+    msg->insert("seq",     seq);
+    msg->insert("changes", batch);
+    send(msg);
+
+    for (auto changes: *batch) checkViz(*changes);
 
   } catch (const Exception &e) {
     close();
@@ -148,18 +213,16 @@ void Remote::onMessage(const JSON::ValuePtr &msg) {
   else if (cmd == "restart") app.getAccount().restart();
   else if (cmd == "link")
     app.getAccount().link(msg->getString("token"), msg->getString("name"));
+  else if (cmd == "batch")   onBatch(msg);
 
   else if (cmd == "viz") {
-    vizUnitID = msg->getString("unit", "");
-    vizFrame  = msg->getU32("frame", 0);
-    sendViz();
+    SmartPointer<VizStream> stream;
+    if (VizStream::isRequested(*msg)) stream = new VizStream(*msg);
+    setViz(msg->getString("unit", ""), msg->getU32("frame", 0), stream);
 
-  } else if (cmd == "log") {
-    if (msg->getBoolean("enable", false))
-      app.getLogTracker().add(PhonyPtr(this), lastLogLine);
-    else app.getLogTracker().remove(PhonyPtr(this));
+  } else if (cmd == "log") onLog(*msg);
 
-  } else if (cmd == "wus") {
+  else if (cmd == "wus") {
     sendWUsEnabled = msg->getBoolean("enable", false);
     sendWUs();
 
@@ -170,27 +233,147 @@ void Remote::onMessage(const JSON::ValuePtr &msg) {
 }
 
 
+void Remote::onBatch(const JSON::ValuePtr &msg) {
+  if (!msg->hasList("cmds")) THROW("Batch missing 'cmds' list");
+  auto cmds = msg->get("cmds");
+
+  // Check the whole batch before applying any of it
+  for (unsigned i = 0; i < cmds->size(); i++) {
+    auto cmd = cmds->get(i);
+    if (!cmd->isDict() || !cmd->hasString("cmd"))
+      THROW("Invalid command in batch at " << i);
+    if (cmd->getString("cmd") == "batch") THROW("Nested batch command");
+  }
+
+  // Changes are written in one DB transaction and sent as one notification.
+  // Commands such as "viz" or "restart" cannot be undone, so when one fails
+  // the commands before it are kept and the rest are skipped.
+  Batch batch(app);
+
+  for (unsigned i = 0; i < cmds->size(); i++) {
+    auto cmd = cmds->get(i);
+
+    // Commands without a time were issued when the batch was
+    if (!cmd->has("time") && msg->has("time"))
+      cmd->insert("time", msg->get("time"));
+
+    try {
+      onMessage(cmd);
+
+    } catch (const Exception &e) {
+      batch.commit();
+      THROW("Batch command " << i << " '" << cmd->getString("cmd")
+            << "' failed, " << i << " earlier commands applied: "
+            << e.getMessage());
+    }
+  }
+
+  batch.commit();
+}
+
+
+void Remote::onLog(const JSON::Value &msg) {
+  auto &tracker = app.getLogTracker();
+
+  // A new filter applies from here on, the remote may query for history
+  if (msg.has("filter")) {
+    auto &filter = *msg.get("filter");
+    logFilter = filter.isDict() ? new LogFilter(app, filter) : 0;
+  }
+
+  if (msg.hasDict("history")) {
+    auto alive = this->alive;
+
+    app.getLogStore().query(
+      *msg.get("history"), logFilter,
+      [this, alive] (const JSON::ValuePtr &lines) {
+        if (!*alive) return;
+
+        JSON::ValuePtr changes = new JSON::List;
+        changes->append("log-history");
+        changes->append(lines);
+        sendChanges(changes);
+      });
+  }
+
+  if (msg.hasDict("query")) {
+    auto &query = *msg.get("query");
+    uint64_t from  = query.getU64("from", 1);
+    uint64_t to    = query.getU64("to", tracker.getLast());
+    unsigned limit = min(query.getU32("limit", maxLogQuery), maxLogQuery);
+
+    JSON::ValuePtr result = new JSON::Dict;
+    result->insert("from",  from);
+    result->insert("to",    to);
+    result->insert("lines", tracker.query(from, to, limit, logFilter.get()));
+
+    JSON::ValuePtr changes = new JSON::List;
+    changes->append("log-query");
+    changes->append(result);
+    sendChanges(changes);
+  }
+
+  // A bare query leaves the live log subscription as it was
+  if (!(msg.has("query") || msg.has("history")) || msg.has("enable")) {
+    if (msg.getBoolean("enable", false))
+      tracker.add(PhonyPtr(this), lastLogLine);
+    else tracker.remove(PhonyPtr(this));
+  }
+}
+
+
 void Remote::onOpen() {
   LOG_DEBUG(3, "New client " << getName());
-  send(PhonyPtr(&app));
+  if (!journaled) return send(PhonyPtr(&app));
+
+  // Resume from the journal if possible, otherwise send a snapshot
+  auto &journal = app.getJournal();
+  bool resume   = journal.canResume(resumeJournal, resumeSeq);
+
+  JSON::ValuePtr msg = new JSON::Dict;
+  msg->insert("journal", journal.getID());
+  msg->insert("seq",     resume ? resumeSeq : journal.getSeq());
+  if (!resume) msg->insert("state", PhonyPtr(&app));
+  send(msg);
+
+  if (resume) {
+    LOG_DEBUG(3, "Resuming client " << getName() << " from " << resumeSeq);
+    journal.replay(resumeSeq, [this] (uint64_t seq, const JSON::ValuePtr &b) {
+      sendBatch(seq, b);
+    });
+  }
 }
 
 
 void Remote::onClose() {
   LOG_DEBUG(3, "Closing client " << getName());
+  setViz("", 0);
   app.getLogTracker().remove(PhonyPtr(this));
   app.remove(*this);
 }
 
 
+void Remote::checkViz(const JSON::Value &changes) {
+  // Check for viz frame changes: ["units", <unit index>, "frames", #]
+  if (changes.size() == 4 && changes.getString(0) == "units" &&
+      changes.getString(2) == "frames") sendViz();
+}
+
+
 void Remote::logUpdate(const JSON::ValuePtr &lines, uint64_t last) {
   bool restart = !lastLogLine || lastLogLine < last - lines->size();
   lastLogLine = last;
 
+  JSON::ValuePtr send = lines;
+  if (logFilter.isSet()) {
+    send = logFilter->filter(*lines);
+    if (!restart && !send->size()) return;
+  }
+
   JSON::ValuePtr changes = new JSON::List;
 
   changes->append("log");
   if (!restart) changes->append(-2);
-  changes->append(lines);
+  changes->append(send);
   sendChanges(changes);
 }
@@ -29,6 +29,8 @@
 #pragma once
 
 #include "LogTracker.h"
+#include "VizStream.h"
+#include "LogFilter.h"
 
 #include <cbang/json/JSON.h>
 #include <cbang/event/Event.h>
@@ -42,14 +44,26 @@ namespace FAH {
     // Limit inbound messages and request bodies from frontends and the node
     const unsigned maxInputSize = 1 << 20;
 
+    // Most log lines returned by one query
+    const unsigned maxLogQuery = 1e4;
+
     class Remote : public LogTracker::Listener, public virtual cb::RefCounted {
       App &app;
 
       std::string vizUnitID;
       unsigned vizFrame = 0;
+      cb::SmartPointer<VizStream> vizStream;
+      cb::Event::EventPtr vizEvent;
       uint64_t lastLogLine = 0;
+      cb::SmartPointer<LogFilter> logFilter;
       bool sendWUsEnabled = false;
 
+      bool journaled = false;
+      std::string resumeJournal;
+      uint64_t resumeSeq = 0;
+
+      cb::SmartPointer<bool> alive = new bool(true);
+
     public:
       Remote(App &app);
       virtual ~Remote();
@@ -60,17 +74,28 @@ namespace FAH {
       virtual void send(const cb::JSON::ValuePtr &msg) = 0;
       virtual void close() = 0;
 
+      bool isJournaled() const {return journaled;}
+      void setResume(const std::string &journal, uint64_t since);
+
+      void setViz(const std::string &unitID, unsigned frame,
+                  const cb::SmartPointer<VizStream> &stream = 0);
       void sendViz();
       void sendWUs();
       void logWU(const Unit &wu);
       void sendChanges(const cb::JSON::ValuePtr &changes);
+      void sendBatch(uint64_t seq, const cb::JSON::ValuePtr &batch);
 
       void onMessage(const cb::JSON::ValuePtr &msg);
+      void onBatch(const cb::JSON::ValuePtr &msg);
+      void onLog(const cb::JSON::Value &msg);
       void onOpen();
       void onClose();
 
       // From LogTracker::Listener
       void logUpdate(const cb::JSON::ValuePtr &lines, uint64_t last) override;
+
+    protected:
+      void checkViz(const cb::JSON::Value &changes);
     };
   }
 }
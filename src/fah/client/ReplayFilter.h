@@ -0,0 +1,48 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+
+namespace FAH {
+  namespace Client {
+    /// Rejects replayed message sequence numbers in constant memory.
+    /// Numbers more than 64 behind the newest seen are rejected as too old.
+    class ReplayFilter {
+      uint64_t last   = 0;
+      uint64_t window = 0; // Bit i is set if last - i was seen
+
+    public:
+      /// @return false if @param seq was already seen or is too old
+      bool check(uint64_t seq);
+      void clear() {last = window = 0;}
+    };
+  }
+}
@@ -29,13 +29,24 @@
 #include "Server.h"
 #include "App.h"
 #include "WebsocketRemote.h"
+#include "Journal.h"
+#include "EventStream.h"
+#include "WebRoot.h"
+#include "LocalSocket.h"
+#include "Groups.h"
+#include "Units.h"
 
 #include <cbang/Info.h>
+#include <cbang/String.h>
 #include <cbang/event/Port.h>
 #include <cbang/log/Logger.h>
 #include <cbang/net/SockAddr.h>
 #include <cbang/net/URI.h>
 #include <cbang/os/SystemUtilities.h>
+#include <cbang/http/Conn.h>
+#include <cbang/net/Socket.h>
+
+#include <cstdlib>
 
 using namespace FAH::Client;
 using namespace cb;
@@ -49,6 +60,7 @@ Server::Server(App &app) :
   app.getOptions()["http-max-body-size"   ].setDefault(maxInputSize);
   app.getOptions()["http-max-headers-size"].setDefault(maxInputSize);
   setPortPriority(3);
+  pruneEvent = app.getEventBase().newEvent([this] {pruneStreams();}, 0);
 }
 
 
@@ -65,19 +77,31 @@ void Server::init() {
 
   addMember(HTTP_GET, "/ping", this, &Server::redirectPing);
   addMember(HTTP_GET, "/api/websocket", this, &Server::handleWebsocket);
+  addMember(HTTP_GET, "/api/state", this, &Server::handleState);
+  addMember(HTTP_GET, "/api/units", this, &Server::handleUnits);
+  addMember(HTTP_GET, "/api/groups/.*", this, &Server::handleGroup);
+  addMember(HTTP_GET, "/api/events", this, &Server::handleEvents);
 
   // Web root
   if (options["web-root"].hasValue()) {
     string root = options["web-root"];
     if (SystemUtilities::exists(root)) {
-      addHandler("/.*", root);
-      addHandler("/.*", root + "/index.html");
+      webRoot = new WebRoot(root);
+      addMember(HTTP_GET, "/.*", this, &Server::handleWebRoot);
     }
   }
 
   // Init
   HTTP::Server::init(options);
 
+#ifndef _WIN32
+  if (options["local-socket"].hasValue()) {
+    string mode = options["local-socket-mode"];
+    localSocket = new LocalSocket(app, *this, options["local-socket"]);
+    localSocket->open(strtoul(mode.c_str(), 0, 8));
+  }
+#endif
+
   addMember(HTTP_GET, "/.*", this, &Server::redirectWebControl);
 }
 
@@ -131,8 +155,82 @@ bool Server::allowedLoopback(const string &origin) const {
 }
 
 
+// Without an Origin, e.g. a same-origin page after DNS rebinding, only allow
+// requests addressed to loopback or to an address this server listens on.
+bool Server::allowedHost(const string &_host) const {
+  try {
+    string host = _host;
+    uint32_t port = 0; // Any
+
+    size_t colon = host.rfind(':');
+    if (colon != string::npos && host.find(']', colon) == string::npos) {
+      port = String::parseU32(host.substr(colon + 1));
+      host = host.substr(0, colon);
+    }
+
+    // Strip IPv6 brackets
+    if (2 < host.size() && host.front() == '[' && host.back() == ']')
+      host = host.substr(1, host.size() - 2);
+
+    bool name = host == "localhost";
+    SockAddr addr;
+    if (!name) addr = SockAddr::parse(host); // Throws on other names
+
+    for (auto &p: getPorts()) {
+      auto &a = p->getAddr();
+
+      if (port && a.getPort() != port) continue;
+      if (name || addr.isLoopback() || a.isZero() ||
+          a.toString(false) == addr.toString(false)) return true;
+    }
+
+  } catch (const Exception &) {} // Malformed or not an address
+
+  return false;
+}
+
+
+void Server::sendBatch(uint64_t seq, const JSON::ValuePtr &batch) {
+  for (auto &stream: streams)
+    stream->sendBatch(seq, batch);
+}
+
+
+// Streams may close from within their own callbacks, so remove them later
+void Server::streamClosed() {pruneEvent->activate();}
+
+
+void Server::pruneStreams() {
+  for (auto it = streams.begin(); it != streams.end();)
+    if ((*it)->isClosed()) it = streams.erase(it);
+    else it++;
+}
+
+
+bool Server::isLocal(HTTP::Request &req) const {
+#ifndef _WIN32
+  auto conn = req.getConnection().toStrongPtr();
+  return localSocket.isSet() && conn.isSet() &&
+    LocalSocket::isLocal(conn->getSocket()->get());
+#else
+  return false;
+#endif
+}
+
+
+void Server::checkHost(HTTP::Request &req) const {
+  // Origin, if any, was already checked by corsCB()
+  if (isLocal(req) || req.inHas("Origin")) return;
+
+  string host = req.inHas("Host") ? req.inGet("Host") : "";
+  if (!allowedHost(host)) THROWX("Access denied by Host: " << host,
+                                 HTTP_UNAUTHORIZED);
+}
+
+
 bool Server::corsCB(HTTP::Request &req) {
-  if (req.inHas("Origin")) {
+  // Local socket access is controlled by file permissions
+  if (req.inHas("Origin") && !isLocal(req)) {
     string origin = req.inGet("Origin");
 
     if (!allowed(origin)) THROWX("Access denied by Origin: " << origin, HTTP_UNAUTHORIZED);
@@ -185,7 +283,76 @@ bool Server::redirectPing(HTTP::Request &req) {
 
 bool Server::handleWebsocket(HTTP::Request &req) {
   auto ws = SmartPtr(new WebsocketRemote(app));
+  auto &uri = req.getURI();
+  if (uri.has("encoding")) ws->setEncoding(uri.get("encoding"));
+  if (uri.has("since")) {
+    string journal = uri.has("journal") ? uri.get("journal") : "";
+    ws->setResume(journal, String::parseU64(uri.get("since")));
+  }
   ws->upgrade(req);
   app.add(ws);
   return true;
 }
+
+
+bool Server::handleEvents(HTTP::Request &req) {
+  checkHost(req);
+  auto stream = SmartPtr(new EventStream(app, req));
+  stream->open();
+  if (!stream->isClosed()) streams.push_back(stream);
+  return true;
+}
+
+
+bool Server::handleWebRoot(HTTP::Request &req) {return webRoot->handle(req);}
+
+
+bool Server::handleState(HTTP::Request &req) {
+  checkHost(req);
+  replySnapshot(req, "state", app);
+  return true;
+}
+
+
+bool Server::handleUnits(HTTP::Request &req) {
+  checkHost(req);
+  replySnapshot(req, "units", *app.getUnits());
+  return true;
+}
+
+
+bool Server::handleGroup(HTTP::Request &req) {
+  checkHost(req);
+  string name = URI::decode(req.getURI().getPath().substr(12));
+  auto groups = app.getGroups();
+
+  if (!groups->has(name)) THROWX("Group not found", HTTP_NOT_FOUND);
+
+  replySnapshot(req, "groups/" + name, *groups->get(name));
+  return true;
+}
+
+
+void Server::replySnapshot(HTTP::Request &req, const string &key,
+                           const JSON::Value &value) {
+  // Any notify() advances the journal and so invalidates all snapshots
+  auto &journal = app.getJournal();
+  uint64_t seq  = journal.getSeq();
+  string etag   = "\"" + journal.getID() + "-" + String(seq) + "\"";
+
+  req.outSet("ETag", etag);
+  req.outSet("Cache-Control", "no-cache");
+
+  if (req.inHas("If-None-Match")) {
+    string match = req.inGet("If-None-Match");
+    if (match == "*" || match.find(etag) != string::npos)
+      return req.reply(HTTP_NOT_MODIFIED);
+  }
+
+  auto &snapshot = snapshots[key];
+  if (snapshot.second.empty() || snapshot.first != seq)
+    snapshot = make_pair(seq, value.toString());
+
+  req.setContentType("application/json");
+  req.reply(snapshot.second);
+}
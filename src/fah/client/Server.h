@@ -29,22 +29,36 @@
 #pragma once
 
 #include <cbang/http/Server.h>
+#include <cbang/event/Event.h>
 #include <cbang/json/Value.h>
 #include <cbang/openssl/SSLContext.h>
 #include <cbang/util/Regex.h>
 
 #include <vector>
+#include <map>
+#include <list>
 
 
 namespace FAH {
   namespace Client {
     class App;
     class Remote;
+    class EventStream;
+    class WebRoot;
+    class LocalSocket;
 
     class Server : public cb::HTTP::Server {
       App &app;
       std::vector<cb::Regex> allowedOrigins;
 
+      // Serialized state keyed by path, valid for one journal sequence
+      std::map<std::string, std::pair<uint64_t, std::string>> snapshots;
+
+      std::list<cb::SmartPointer<EventStream>> streams;
+      cb::Event::EventPtr pruneEvent;
+      cb::SmartPointer<WebRoot> webRoot;
+      cb::SmartPointer<LocalSocket> localSocket;
+
     public:
       Server(App &app);
 
@@ -52,15 +66,30 @@ namespace FAH {
 
       bool allowed(const std::string &origin) const;
       bool allowedLoopback(const std::string &origin) const;
+      bool allowedHost(const std::string &host) const;
+      bool isLocal(cb::HTTP::Request &req) const;
+
+      bool hasStreams() const {return !streams.empty();}
+      void sendBatch(uint64_t seq, const cb::JSON::ValuePtr &batch);
+      void streamClosed();
 
       // From cb::HTTP::Server
       using cb::HTTP::Server::init;
 
     protected:
+      void checkHost(cb::HTTP::Request &req) const;
+      void pruneStreams();
       bool corsCB(cb::HTTP::Request &req);
       bool redirectWebControl(cb::HTTP::Request &req);
       bool redirectPing(cb::HTTP::Request &req);
       bool handleWebsocket(cb::HTTP::Request &req);
+      bool handleState(cb::HTTP::Request &req);
+      bool handleUnits(cb::HTTP::Request &req);
+      bool handleGroup(cb::HTTP::Request &req);
+      bool handleEvents(cb::HTTP::Request &req);
+      bool handleWebRoot(cb::HTTP::Request &req);
+      void replySnapshot(cb::HTTP::Request &req, const std::string &key,
+                         const cb::JSON::Value &value);
     };
   }
 }
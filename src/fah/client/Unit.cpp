@@ -38,6 +38,8 @@
 #include "Cores.h"
 #include "Config.h"
 #include "ExitCode.h"
+#include "WorkerThread.h"
+#include "JSONPath.h"
 
 #include <cbang/Catch.h>
 
@@ -74,9 +76,27 @@ using namespace std;
 
 
 namespace {
-  static const uint64_t maxViewerBytes = 2.5e7;
+  static const uint64_t maxViewerBytes     = 2.5e7; // Decoded
+  static const uint64_t maxViewerFileBytes = 2.5e7; // Parsed as a full DOM
+  static const double   viewerReleaseDelay = 5 * 60; // Seconds
   static const double   csRetryDelay   = 5; // Seconds between CS attempts
 
+  // Paths into the unit data
+  const JSONPath requestIDPath("request.data.id");
+  const JSONPath requestTimePath("request.data.time");
+  const JSONPath assignmentPath("assignment.data");
+  const JSONPath wsPath("assignment.data.ws");
+  const JSONPath corePath("assignment.data.core");
+  const JSONPath minCPUsPath("assignment.data.min_cpus");
+  const JSONPath maxCPUsPath("assignment.data.max_cpus");
+  const JSONPath timeoutPath("assignment.data.timeout");
+  const JSONPath deadlinePath("assignment.data.deadline");
+  const JSONPath creditPath("assignment.data.credit");
+  const JSONPath wuPath("wu.data");
+  const JSONPath csPath("wu.data.cs");
+  const JSONPath estimatePath("wu.data.estimate");
+  const JSONPath resultsStatusPath("results.status");
+
 
   string idFromSig(const string &sig) {
     if (sig.empty()) return "";
@@ -133,7 +153,7 @@ Unit::Unit(App &app, const string &group, uint64_t wu, uint32_t cpus,
 
 
 Unit::Unit(App &app, const JSON::ValuePtr &data) : Unit(app) {
-  this->data = data->get("data");
+  setData(data->get("data"));
   merge(*data->get("state"));
 
   // Get group
@@ -158,14 +178,19 @@ Unit::Unit(App &app, const JSON::ValuePtr &data) : Unit(app) {
 
 
 Unit::~Unit() {
+  *alive = false;
   cancelRequest();
   endLogCopy();
+  stopWatch();
+  if (group.isSet()) group->removeUnit(this);
 }
 
 
 void Unit::setGroup(const SmartPointer<Group> &group) {
+  if (this->group.isSet()) this->group->removeUnit(this);
   insert("group", group->getName());
   this->group = group;
+  group->addUnit(this);
 }
 
 
@@ -173,11 +198,11 @@ const Config &Unit::getConfig() const {return group->getConfig();}
 
 
 string Unit::getClientID() const {
-  return data->selectString("request.data.id", "");
+  return requestIDPath.selectString(*data, "");
 }
 
 
-UnitState Unit::getState() const {return UnitState::parse(getString("state"));}
+UnitState Unit::getState() const {return getFields().state;}
 
 
 bool Unit::atRunState() const {
@@ -217,16 +242,14 @@ void Unit::setCPUs(uint32_t cpus) {
 
 
 uint32_t Unit::getMinCPUs() const {
-  uint32_t cpus = getCPUs();
-  return data.isSet() ?
-    data->selectU32("assignment.data.min_cpus", cpus) : cpus;
+  auto &f = getDataFields();
+  return f.hasMinCPUs ? f.minCPUs : getCPUs();
 }
 
 
 uint32_t Unit::getMaxCPUs() const {
-  uint32_t cpus = getCPUs();
-  return data.isSet() ?
-    data->selectU32("assignment.data.max_cpus", cpus) : cpus;
+  auto &f = getDataFields();
+  return f.hasMaxCPUs ? f.maxCPUs : getCPUs();
 }
 
 
@@ -234,25 +257,14 @@ void Unit::setGPUs(const std::set<string> &gpus) {
   auto l = createList();
   for (auto id: gpus) l->append(id);
   insert("gpus", l);
+  fields.valid = false;
 }
 
 
-std::set<string> Unit::getGPUs() const {
-  std::set<string> gpus;
-  for (auto gpu: *get("gpus"))
-    gpus.insert(gpu->getString());
-  return gpus;
-}
-
+const std::set<string> &Unit::getGPUs() const {return getFields().gpus;}
 
-bool Unit::hasGPU(const string &id) const {
-  auto const &gpus = getGPUs();
 
-  for (auto gpuID: gpus)
-    if (gpuID == id) return true;
-
-  return false;
-}
+bool Unit::hasGPU(const string &id) const {return getFields().gpus.count(id);}
 
 
 uint64_t Unit::getRunTimeDelta() const {
@@ -273,15 +285,15 @@ uint64_t Unit::getRunTime() const {
 
 uint64_t Unit::getRunTimeEstimate() const {
   // If valid, use estimate provided by the WS
-  uint64_t estimate = data->selectU64("wu.data.estimate", 0);
-  if (estimate) return estimate;
+  auto &f = getDataFields();
+  if (f.estimate) return f.estimate;
 
   // Make our own estimate
   if (getKnownProgress() && lastKnownProgressUpdateRunTime)
     return lastKnownProgressUpdateRunTime / getKnownProgress();
 
   // Make a wild guess based on timeout or 1 day
-  return 0.2 * data->selectU64("assignment.data.timeout", Time::SEC_PER_DAY);
+  return 0.2 * (f.hasTimeout ? f.timeout : Time::SEC_PER_DAY);
 }
 
 
@@ -304,15 +316,15 @@ double Unit::getEstimatedProgress() const {
 
 
 uint64_t Unit::getCreditEstimate() const {
-  uint64_t credit = data->selectU64("assignment.data.credit", 0);
+  auto &f = getDataFields();
+  uint64_t credit = f.credit;
 
   // Compute bonus estimate
   // Use request time to account for potential client/AS clock offset
   // Note, if the client's clock has changed ``requested`` may be < now
-  uint64_t requested = Time::parse(data->selectString("request.data.time"));
-  uint64_t timeout   = data->selectU64("assignment.data.timeout",  0);
-  uint64_t deadline  = data->selectU64("assignment.data.deadline", 0);
-  int64_t  delta     = (int64_t)Time::now() - requested + getETA();
+  uint64_t timeout  = f.timeout;
+  uint64_t deadline = f.deadline;
+  int64_t  delta    = (int64_t)Time::now() - f.requested + getETA();
 
   // No bonus after timeout
   if (0 < delta && delta < (int64_t)timeout) {
@@ -346,15 +358,16 @@ string Unit::getDirectory() const {
 
 
 URI Unit::getWSURL(const string &path) const {
-  string host = data->selectString("assignment.data.ws");
+  string host = wsPath.selectString(*data);
   return URI("https", host, 0, "/api" + path);
 }
 
 
 uint64_t Unit::getDeadline() const {
   // Use request time to account for potential client/AS clock offset
-  return Time::parse(data->selectString("request.data.time")) +
-    data->selectU64("assignment.data.deadline");
+  auto &f = getDataFields();
+  if (!f.hasDeadline) THROW("WU has no deadline");
+  return f.requested + f.deadline;
 }
 
 
@@ -385,6 +398,65 @@ bool Unit::isExpired() const {
 void Unit::triggerNext(double secs) {event->add(secs);}
 
 
+void Unit::notify(const list<JSON::ValuePtr> &change) {
+  if (change.empty()) return;
+
+  string key = change.front()->getString();
+  if (key == "state" || key == "gpus") fields.valid = false;
+}
+
+
+const Unit::fields_t &Unit::getFields() const {
+  if (!fields.valid) {
+    fields.state = UnitState::parse(getString("state"));
+
+    fields.gpus.clear();
+    if (hasList("gpus"))
+      for (auto gpu: *get("gpus"))
+        fields.gpus.insert(gpu->getString());
+
+    fields.valid = true;
+  }
+
+  return fields;
+}
+
+
+const Unit::data_fields_t &Unit::getDataFields() const {
+  if (!dataFields.valid) {
+    auto &f = dataFields;
+    f = data_fields_t();
+
+    if (data.isSet()) {
+      auto &d = *data;
+      string requested = requestTimePath.selectString(d, "");
+      if (!requested.empty()) f.requested = Time::parse(requested);
+
+      f.hasMinCPUs  = minCPUsPath.has(d);
+      f.hasMaxCPUs  = maxCPUsPath.has(d);
+      f.hasTimeout  = timeoutPath.has(d);
+      f.hasDeadline = !requested.empty() && deadlinePath.has(d);
+      f.minCPUs     = minCPUsPath.selectU32(d, 0);
+      f.maxCPUs     = maxCPUsPath.selectU32(d, 0);
+      f.timeout     = timeoutPath.selectU64(d, 0);
+      f.deadline    = deadlinePath.selectU64(d, 0);
+      f.estimate    = estimatePath.selectU64(d, 0);
+      f.credit      = creditPath.selectU64(d, 0);
+    }
+
+    f.valid = true;
+  }
+
+  return dataFields;
+}
+
+
+void Unit::setData(const JSON::ValuePtr &data) {
+  this->data = data;
+  dataFields.valid = false;
+}
+
+
 void Unit::dumpWU() {
   LOG_INFO(3, "Dumping " << id);
 
@@ -425,6 +497,7 @@ void Unit::setState(UnitState state) {
   if (hasString("state") && state == getState()) return;
   if (group.isSet()) group->triggerUpdate();
   insert("state", state.toString());
+  fields.valid = false; // Also if not yet observed
   clearProgress();
 }
 
@@ -505,6 +578,7 @@ void Unit::processEnded() {
   erase("start_time");
   erase("pid");
   processStartTime = 0;
+  stopWatch();
 }
 
 
@@ -559,7 +633,7 @@ void Unit::setProgress(double done, double total, bool wu) {
 void Unit::getCore() {
   if (core.isSet()) return; // Already have core
 
-  core = app.getCores().get(data->select("assignment.data.core"));
+  core = app.getCores().get(corePath.select(*data));
 
   auto cb =
     [this] (unsigned complete, int total) {
@@ -575,6 +649,7 @@ void Unit::getCore() {
         setCPUs(assign->getU32("cpus"));
         if (assign->hasList("gpus")) insert("gpus", assign->get("gpus"));
         else get("gpus")->clear();
+        fields.valid = false;
 
         setState(UNIT_RUN);
         setPause(true); // Let Group start this WU when appropriate
@@ -654,16 +729,47 @@ void Unit::run() {
   auto process = SmartPtr(new CoreProcess(core->getPath()));
   process->exec(args);
   processStarted(process);
+  process->onExit(app.getEventBase(), [this] {triggerNext();});
+  startWatch();
   startLogCopy(logFile); // Redirect core output to log
   triggerNext();
 
-  insert("assignment", data->select("assignment.data"));
-  insert("wu",         data->select("wu.data"));
+  insert("assignment", assignmentPath.select(*data));
+  insert("wu",         wuPath.select(*data));
   if (!has("wu_progress")) insert("wu_progress", 0);
 }
 
 
+void Unit::startWatch() {
+  stopWatch();
+  watchID = app.getWatcher().watch(
+    getDirectory(), [this] (const string &name) {fileChanged(name);});
+}
+
+
+void Unit::stopWatch() {
+  app.getWatcher().unwatch(watchID);
+  watchID     = -1;
+  infoChanged = viewerChanged = true;
+}
+
+
+void Unit::fileChanged(const string &name) {
+  bool all = name.empty() || name == "*";
+  if (name.empty()) watchID = -1; // Directory removed, back to polling
+
+  // Events were lost and may be again, poll for the rest of this run
+  if (name == "*") return stopWatch();
+
+  if (all || name == "wuinfo_01.dat") infoChanged = true;
+  if (all || !name.compare(0, 6, "viewer")) viewerChanged = true;
+}
+
+
 void Unit::readInfo() {
+  if (0 <= watchID && !infoChanged) return;
+  infoChanged = false;
+
   string filename = getDirectory() + "/wuinfo_01.dat";
 
   if (SystemUtilities::exists(filename)) {
@@ -686,76 +792,180 @@ void Unit::readInfo() {
 }
 
 
+void Unit::addViewer() {
+  if (releaseEvent.isSet()) releaseEvent->del();
+  viewerChanged = true;
+  if (!viewers++) triggerNext(); // Start loading
+}
+
+
+void Unit::removeViewer() {
+  if (!viewers || --viewers) return;
+
+  // Keep the data for a while in case the viewer comes back
+  if (releaseEvent.isNull())
+    releaseEvent =
+      app.getEventBase().newEvent([this] {releaseViewer();}, 0);
+  releaseEvent->add(viewerReleaseDelay);
+}
+
+
+void Unit::releaseViewer() {
+  if (viewers || viewer.isNull()) return;
+
+  LOG_DEBUG(3, "Releasing visualization data");
+
+  viewer.release();
+  viewerFrame = 0;
+  if (0 < viewerFail) viewerFail = 0;
+  insert("frames", (uint32_t)0);
+}
+
+
 void Unit::readViewerData() {
-  if (viewerFail < 0 || getState() < UNIT_CORE) return;
+  // Only load visualization data while a remote is watching
+  if (!viewers || viewerFail < 0 || viewerLoading || getState() < UNIT_CORE)
+    return;
+
+  if (0 <= watchID && !viewerChanged) return;
+  viewerChanged = false;
 
   try {
-    if (topology.isNull()) readViewerTop();
-    return readViewerFrame();
+    if (viewer.isNull()) readViewerTop();
+    else readViewerFrame();
+    return;
   } CATCH_DEBUG(3);
 
-  if (5 < ++viewerFail) {
-    if (topology.isNull()) {
-      LOG_WARNING("Giving up on reading visualization");
-      viewerFail = -1;
-
-    } else {
-      LOG_WARNING("Giving up on reading visualization frame " << viewerFrame++);
-      viewerFail = 0;
-    }
-  }
+  viewerError();
 }
 
 
 void Unit::readViewerTop() {
   string filename = getDirectory() + "/viewerTop.json";
+  if (!existsAndOlderThan(filename, 10)) {
+    viewerChanged = SystemUtilities::exists(filename); // Wait for it to settle
+    return;
+  }
 
-  if (existsAndOlderThan(filename, 10)) {
-    frames.clear();
-    viewerBytes = SystemUtilities::getFileSize(filename);
+  if (maxViewerFileBytes < SystemUtilities::getFileSize(filename)) {
+    LOG_WARNING("Visualization topology too large, disabling visualization");
+    viewerFail = -1;
+    return;
+  }
 
-    if (maxViewerBytes < viewerBytes) {
-      LOG_WARNING("Visualization topology too large, disabling visualization");
-      viewerFail = -1;
-      return;
-    }
+  // Parse on the worker thread, the file may be large
+  auto topology = SmartPtr(new SmartPointer<Viewer::Topology>);
+  auto alive    = this->alive;
+  viewerLoading = true;
 
-    topology = JSON::Reader::parseFile(filename);
-    viewerFail = 0;
-  }
+  app.getWorker().submit(
+    [filename, topology] {
+      *topology = new Viewer::Topology(*JSON::Reader::parseFile(filename));
+    },
+    [this, alive, topology] (const string &error) {
+      if (*alive) topologyLoaded(*topology, error);
+    });
 }
 
 
 void Unit::readViewerFrame() {
   string filename =
     getDirectory() + String::printf("/viewerFrame%d.json", viewerFrame);
+  if (!existsAndOlderThan(filename, 10)) {
+    viewerChanged = SystemUtilities::exists(filename); // Wait for it to settle
+    return;
+  }
+
+  if (maxViewerFileBytes < SystemUtilities::getFileSize(filename)) {
+    LOG_WARNING("Visualization frame " << viewerFrame
+      << " too large, no more frames will be loaded");
+    viewerFail = -1;
+    return;
+  }
+
+  auto frame    = SmartPtr(new SmartPointer<Viewer::Frame>);
+  auto alive    = this->alive;
+  viewerLoading = true;
+
+  app.getWorker().submit(
+    [filename, frame] {
+      *frame = new Viewer::Frame(*JSON::Reader::parseFile(filename));
+    },
+    [this, alive, frame] (const string &error) {
+      if (*alive) frameLoaded(*frame, error);
+    });
+}
 
-  if (existsAndOlderThan(filename, 10)) {
-    uint64_t bytes = SystemUtilities::getFileSize(filename);
 
-    if (maxViewerBytes < viewerBytes + bytes) {
-      LOG_WARNING("Visualization size exceeded at frame " << viewerFrame
-        << ", no more frames will be loaded");
+void Unit::viewerError() {
+  viewerChanged = true; // Retry
+  if (5 < ++viewerFail) {
+    if (viewer.isNull()) {
+      LOG_WARNING("Giving up on reading visualization");
       viewerFail = -1;
-      return;
+
+    } else {
+      LOG_WARNING("Giving up on reading visualization frame " << viewerFrame++);
+      viewerFail = 0;
     }
+  }
+}
 
-    auto frame = JSON::Reader::parseFile(filename);
 
-    if (!frames.empty() && *frames.back() == *frame)
-      LOG_WARNING("Visualization frame " << viewerFrame
-        << " unchanged, skipping");
+void Unit::topologyLoaded(const SmartPointer<Viewer::Topology> &topology,
+                          const string &error) {
+  viewerLoading = false;
 
-    else if (!frame->empty()) {
-      frames.push_back(frame);
-      insert("frames", (uint32_t)frames.size());
-      viewerBytes += bytes;
-    }
+  if (!error.empty()) {
+    LOG_DEBUG(3, "Failed to read visualization topology: " << error);
+    return viewerError();
+  }
+
+  if (maxViewerBytes < topology->getBytes()) {
+    LOG_WARNING("Visualization topology too large, disabling visualization");
+    viewerFail = -1;
+    return;
+  }
 
-    viewerFrame++;
-    viewerFail = 0;
-    triggerNext(); // Try to load another frame
+  viewer = new Viewer;
+  viewer->setTopology(topology);
+  viewerFail    = 0;
+  viewerChanged = true;
+  triggerNext(); // Try to load the first frame
+}
+
+
+void Unit::frameLoaded(const SmartPointer<Viewer::Frame> &frame,
+                       const string &error) {
+  viewerLoading = false;
+
+  if (!error.empty()) {
+    LOG_DEBUG(3, "Failed to read visualization frame " << viewerFrame << ": "
+              << error);
+    return viewerError();
+  }
+
+  if (maxViewerBytes < viewer->getBytes() + frame->getBytes()) {
+    LOG_WARNING("Visualization size exceeded at frame " << viewerFrame
+      << ", no more frames will be loaded");
+    viewerFail = -1;
+    return;
   }
+
+  unsigned count = viewer->getFrameCount();
+  if (count && viewer->getFrame(count - 1) == *frame)
+    LOG_WARNING("Visualization frame " << viewerFrame
+      << " unchanged, skipping");
+
+  else if (!frame->empty()) {
+    viewer->addFrame(frame);
+    insert("frames", viewer->getFrameCount());
+  }
+
+  viewerFrame++;
+  viewerFail    = 0;
+  viewerChanged = true;
+  triggerNext(); // Try to load another frame
 }
 
 
@@ -926,8 +1136,8 @@ void Unit::retry() {
 
   try {
     // Retry results with CS
-    if (getState() == UNIT_UPLOAD && data->select("wu.data")->hasList("cs")) {
-      auto const &csList = data->selectList("wu.data.cs");
+    if (getState() == UNIT_UPLOAD && csPath.has(*data)) {
+      auto const &csList = *csPath.select(*data);
 
       if (csList.size()) {
         if (cs <  (int)csList.size()) cs++;
@@ -988,7 +1198,7 @@ void Unit::assignResponse(const JSON::ValuePtr &data) {
   LOG_DEBUG(3, "Received assignment for " << assign->getU32("cpus")
     << " cpus and " << get("gpus")->size() << " gpus");
 
-  this->data = data;
+  setData(data);
   setState(UNIT_DOWNLOAD);
 }
 
@@ -1065,11 +1275,12 @@ void Unit::writeRequest(JSON::Sink &sink) const {
 void Unit::assign() {
   if (pr.isSet()) return; // Already assigning
 
-  data = JSON::build([this] (JSON::Sink &sink) {writeRequest(sink);});
+  setData(JSON::build([this] (JSON::Sink &sink) {writeRequest(sink);}));
   string signature = app.getKey().signSHA256(data->toString());
 
   id = idFromSig(signature);
   insert("id", id);
+  app.getUnits()->reindex();
 
   // TODO validate peer certificate
   URI uri("https", app.getNextAS(), 0, "/api/assign");
@@ -1131,7 +1342,7 @@ void Unit::downloadResponse(const JSON::ValuePtr &data) {
   }
 
   setState(UNIT_CORE);
-  this->data = data;
+  setData(data);
   save();
 }
 
@@ -1159,7 +1370,7 @@ void Unit::download() {
 void Unit::uploadResponse(const JSON::ValuePtr &data) {
   LOG_INFO(1, "Credited");
   logCredit(data);
-  string status = data->selectString("results.status", "failed");
+  string status = resultsStatusPath.selectString(*data, "failed");
   clean(status == "ok" ? "credited" : status);
 }
 
@@ -1175,7 +1386,7 @@ void Unit::upload() {
   URI uri;
   if (cs == -1) uri = getWSURL("/results");
   else {
-    auto const &csList = data->selectList("wu.data.cs");
+    auto const &csList = *csPath.select(*data);
     string host = csList.getString(cs);
     uri = URI("https", host, 0, "/api/results");
   }
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "UnitState.h"
+#include "Viewer.h"
 
 #include <cbang/json/Observable.h>
 #include <cbang/event/Event.h>
@@ -62,14 +63,23 @@ namespace FAH {
       uint64_t    wu;
       std::string id;
 
-      cb::JSON::ValuePtr              data;
-      cb::JSON::ValuePtr              topology;
-      std::vector<cb::JSON::ValuePtr> frames;
-      cb::SmartPointer<Core>          core;
+      cb::JSON::ValuePtr      data;
+      cb::SmartPointer<Viewer> viewer;
+      cb::SmartPointer<Core>   core;
 
-      unsigned viewerFrame = 0;
-      int      viewerFail  = 0;
-      uint64_t viewerBytes = 0;
+      unsigned viewerFrame   = 0;
+      int      viewerFail    = 0;
+      bool     viewerLoading = false;
+      unsigned viewers       = 0; // Remotes watching this unit
+      cb::Event::EventPtr releaseEvent;
+
+      // While watched, work files are only read after they change
+      int  watchID       = -1;
+      bool infoChanged   = true;
+      bool viewerChanged = true;
+
+      // Cleared on destruction, for callbacks which may outlive the unit
+      cb::SmartPointer<bool> alive = new bool(true);
 
       cb::SmartPointer<CoreProcess> process;
       cb::SmartPointer<cb::TailFileToLog> logCopier;
@@ -89,6 +99,32 @@ namespace FAH {
       uint64_t lastKnownProgressUpdate        = 0;
       uint64_t lastKnownProgressUpdateRunTime = 0;
 
+      // Typed copies of fields read on hot paths.  The JSON stays the source
+      // of truth, these are rebuilt after it changes.
+      struct fields_t {
+        bool valid = false;
+        UnitState state;
+        std::set<std::string> gpus;
+      };
+
+      struct data_fields_t {
+        bool valid = false;
+        bool hasMinCPUs = false;
+        bool hasMaxCPUs = false;
+        bool hasTimeout = false;
+        bool hasDeadline = false;
+        uint32_t minCPUs = 0;
+        uint32_t maxCPUs = 0;
+        uint64_t requested = 0; // Request time
+        uint64_t deadline = 0;
+        uint64_t timeout = 0;
+        uint64_t estimate = 0;
+        uint64_t credit = 0;
+      };
+
+      mutable fields_t fields;
+      mutable data_fields_t dataFields;
+
       Unit(App &app);
 
     public:
@@ -104,8 +140,9 @@ namespace FAH {
 
       const std::string &getID() const {return id;}
       std::string getClientID() const;
-      cb::JSON::ValuePtr getTopology() const {return topology;}
-      const std::vector<cb::JSON::ValuePtr> &getFrames() const {return frames;}
+      cb::SmartPointer<Viewer> getViewer() const {return viewer;}
+      void addViewer();
+      void removeViewer();
       unsigned getRetries() const {return retries;}
 
       UnitState getState() const;
@@ -122,7 +159,7 @@ namespace FAH {
       uint32_t getMinCPUs() const;
       uint32_t getMaxCPUs() const;
       void setGPUs(const std::set<std::string> &gpus);
-      std::set<std::string> getGPUs() const;
+      const std::set<std::string> &getGPUs() const;
       bool hasGPU(const std::string &id) const;
       bool hasGPUs() const {return !getGPUs().empty();}
 
@@ -145,7 +182,14 @@ namespace FAH {
       void dumpWU();
       void save();
 
+      // From cb::JSON::Value
+      void notify(const std::list<cb::JSON::ValuePtr> &change) override;
+
     protected:
+      const fields_t &getFields() const;
+      const data_fields_t &getDataFields() const;
+      void setData(const cb::JSON::ValuePtr &data);
+
       void cancelRequest();
       void setState(UnitState state);
       void next();
@@ -160,10 +204,19 @@ namespace FAH {
       void setProgress(double done, double total, bool wu = false);
       void getCore();
       void run();
+      void startWatch();
+      void stopWatch();
+      void fileChanged(const std::string &name);
       void readInfo();
       void readViewerData();
       void readViewerTop();
       void readViewerFrame();
+      void viewerError();
+      void releaseViewer();
+      void topologyLoaded(const cb::SmartPointer<Viewer::Topology> &topology,
+                          const std::string &error);
+      void frameLoaded(const cb::SmartPointer<Viewer::Frame> &frame,
+                       const std::string &error);
       void setResults(const std::string &status, const std::string &dataHash);
       void finalizeRun();
       void stopRun();
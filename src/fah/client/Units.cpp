@@ -30,6 +30,7 @@
 
 #include "App.h"
 #include "Unit.h"
+#include "Group.h"
 
 #include <cbang/Catch.h>
 #include <cbang/json/JSON.h>
@@ -77,12 +78,27 @@ bool Units::hasFailure() const {
 }
 
 
-void Units::add(const SmartPointer<Unit> &unit) {append(unit);}
+void Units::add(const SmartPointer<Unit> &unit) {
+  append(unit);
+  if (!unit->getID().empty()) index[unit->getID()] = size() - 1;
+}
 
 
 int Units::getUnitIndex(const string &id) const {
+  auto it = index.find(id);
+  return it == index.end() ? -1 : it->second;
+}
+
+
+int Units::getUnitIndex(const Unit *unit) const {
+  // Units without an ID, e.g. cleaned before assignment, are not indexed
+  if (!unit->getID().empty()) {
+    int i = getUnitIndex(unit->getID());
+    return 0 <= i && getUnit(i).get() == unit ? i : -1;
+  }
+
   for (unsigned i = 0; i < size(); i++)
-    if (getUnit(i)->getID() == id) return i;
+    if (getUnit(i).get() == unit) return i;
 
   return -1;
 }
@@ -107,8 +123,36 @@ SmartPointer<Unit> Units::getUnit(const string &id) const {
 }
 
 
+void Units::removeUnit(unsigned index) {
+  auto unit = getUnit(index);
+
+  // The unit may outlive its removal, so its group must not walk it
+  unit->getGroup().removeUnit(unit.get());
+
+  erase(index);
+  reindex(); // Later units moved down
+}
+
+
 void Units::removeUnit(const string &id) {
   int index = getUnitIndex(id);
   if (index == -1) THROW("Invalid unit " << id);
-  erase(index);
+  removeUnit((unsigned)index);
+}
+
+
+void Units::removeUnit(const Unit *unit) {
+  int index = getUnitIndex(unit);
+  if (index == -1) THROW("Invalid unit " << unit->getID());
+  removeUnit((unsigned)index);
+}
+
+
+void Units::reindex() {
+  index.clear();
+
+  for (unsigned i = 0; i < size(); i++) {
+    auto &id = getUnit(i)->getID();
+    if (!id.empty()) index[id] = i;
+  }
 }
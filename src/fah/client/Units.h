@@ -30,10 +30,14 @@
 
 #include "Unit.h"
 
+#include <unordered_map>
+
 
 namespace FAH {
   namespace Client {
     class Units : public cb::JSON::ObservableList {
+      std::unordered_map<std::string, unsigned> index; // ID to list position
+
     public:
       Units(App &app);
 
@@ -42,10 +46,16 @@ namespace FAH {
 
       void add(const cb::SmartPointer<Unit> &unit);
       int getUnitIndex(const std::string &id) const;
+      int getUnitIndex(const Unit *unit) const;
       cb::SmartPointer<Unit> findUnit(const std::string &id);
       cb::SmartPointer<Unit> getUnit(unsigned index) const;
       cb::SmartPointer<Unit> getUnit(const std::string &id) const;
+      void removeUnit(unsigned index);
       void removeUnit(const std::string &id);
+      void removeUnit(const Unit *unit);
+
+      /// Must be called when a unit's ID changes
+      void reindex();
     };
   }
 }
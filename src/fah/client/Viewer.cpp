@@ -0,0 +1,315 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "Viewer.h"
+
+#include <cbang/Exception.h>
+#include <cbang/json/JSON.h>
+
+#include <map>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace FAH::Client;
+using namespace cb;
+using namespace std;
+
+
+namespace {
+  atomic<uint64_t> nextTopologyID(1); // Topologies are parsed on a worker
+
+
+  uint64_t jsonBytes(const JSON::ValuePtr &value) {
+    return value.isNull() ? 0 : value->toString().size();
+  }
+}
+
+
+double Viewer::toDouble(float x) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.7g", x);
+  return strtod(buf, 0);
+}
+
+
+Viewer::Topology::Topology(const JSON::Value &topology) :
+  id(nextTopologyID++) {
+  if (!topology.isDict()) THROW("Visualization topology is not a dictionary");
+
+  other = new JSON::Dict;
+
+  for (unsigned i = 0; i < topology.size(); i++) {
+    const string &key = topology.keyAt(i);
+    auto &value = *topology.get(i);
+
+    if (key == "atoms" && packAtoms(value)) continue;
+    if (key == "bonds" && packBonds(value)) continue;
+
+    other->insert(key, topology.get(i));
+  }
+
+  bytes = atomNumbers.size() * sizeof(float) +
+    (atomStrings.size() + bonds.size()) * sizeof(uint32_t) +
+    jsonBytes(other);
+  for (auto &s: strings) bytes += s.size();
+}
+
+
+vector<uint32_t> Viewer::Topology::select(const string &lod) const {
+  vector<uint32_t> atoms;
+  if (lod != "ca" && lod != "heavy") return atoms;
+
+  unsigned stringFields = 0;
+  for (auto isString: stringField) if (isString) stringFields++;
+
+  for (unsigned i = 0; i < atomCount; i++) {
+    bool ca = false, hydrogen = false;
+
+    for (unsigned j = 0; j < stringFields; j++) {
+      const string &s = strings[atomStrings[i * stringFields + j]];
+      if (s == "CA") ca = true;
+      if (s == "H")  hydrogen = true;
+    }
+
+    if (lod == "ca" ? ca : !hydrogen) atoms.push_back(i);
+  }
+
+  // Nothing to reduce, or no way to tell
+  if (atoms.size() == atomCount) atoms.clear();
+
+  return atoms;
+}
+
+
+JSON::ValuePtr Viewer::Topology::toJSON(const vector<uint32_t> &select) const {
+  JSON::ValuePtr topology = other->copy();
+  bool all = select.empty();
+
+  // Map old to new atom indices
+  vector<int64_t> index;
+  if (!all) {
+    index.resize(atomCount, -1);
+    for (unsigned i = 0; i < select.size(); i++) index[select[i]] = i;
+  }
+
+  if (atomCount) {
+    JSON::ValuePtr atoms = new JSON::List;
+    unsigned fields = stringField.size();
+    unsigned stringFields = 0;
+    for (auto isString: stringField) if (isString) stringFields++;
+    unsigned numberFields = fields - stringFields;
+
+    unsigned count = all ? atomCount : select.size();
+    for (unsigned k = 0; k < count; k++) {
+      unsigned i = all ? k : select[k];
+      unsigned n = i * numberFields, s = i * stringFields;
+      JSON::ValuePtr atom = new JSON::List;
+
+      for (unsigned j = 0; j < fields; j++)
+        if (stringField[j]) atom->append(strings[atomStrings[s++]]);
+        else atom->append(toDouble(atomNumbers[n++]));
+
+      atoms->append(atom);
+    }
+
+    topology->insert("atoms", atoms);
+  }
+
+  if (!bonds.empty()) {
+    JSON::ValuePtr list = new JSON::List;
+
+    for (unsigned i = 0; i < bonds.size(); i += 2) {
+      int64_t a = bonds[i], b = bonds[i + 1];
+
+      if (!all) {
+        if (atomCount <= a || atomCount <= b) continue;
+        a = index[a];
+        b = index[b];
+        if (a < 0 || b < 0) continue;
+      }
+
+      JSON::ValuePtr bond = new JSON::List;
+      bond->append(a);
+      bond->append(b);
+      list->append(bond);
+    }
+
+    topology->insert("bonds", list);
+  }
+
+  if (!all) {
+    JSON::ValuePtr list = new JSON::List;
+    for (auto i: select) list->append(i);
+    topology->insert("atom_indices", list);
+  }
+
+  return topology;
+}
+
+
+bool Viewer::Topology::packAtoms(const JSON::Value &atoms) {
+  if (!atoms.isList() || !atoms.size() || !atoms.get(0)->isList()) return false;
+
+  // The first atom determines the field types
+  auto &first = *atoms.get(0);
+  vector<bool> types;
+  for (unsigned j = 0; j < first.size(); j++) {
+    auto &field = *first.get(j);
+    if (!field.isString() && !field.isNumber()) return false;
+    types.push_back(field.isString());
+  }
+
+  vector<float>    numbers;
+  vector<uint32_t> indices;
+  vector<string>   pool;
+  map<string, uint32_t> lookup;
+
+  for (unsigned i = 0; i < atoms.size(); i++) {
+    auto &atom = *atoms.get(i);
+    if (!atom.isList() || atom.size() != types.size()) return false;
+
+    for (unsigned j = 0; j < types.size(); j++) {
+      auto &field = *atom.get(j);
+
+      if (types[j]) {
+        if (!field.isString()) return false;
+
+        auto result = lookup.insert(make_pair(field.getString(), pool.size()));
+        if (result.second) pool.push_back(field.getString());
+        indices.push_back(result.first->second);
+
+      } else if (field.isNumber()) numbers.push_back(field.getNumber());
+      else return false;
+    }
+  }
+
+  atomCount = atoms.size();
+  stringField.swap(types);
+  atomNumbers.swap(numbers);
+  atomStrings.swap(indices);
+  strings.swap(pool);
+
+  return true;
+}
+
+
+bool Viewer::Topology::packBonds(const JSON::Value &bonds) {
+  if (!bonds.isList()) return false;
+
+  vector<uint32_t> packed;
+  packed.reserve(bonds.size() * 2);
+
+  for (unsigned i = 0; i < bonds.size(); i++) {
+    auto &bond = *bonds.get(i);
+
+    if (!bond.isList() || bond.size() != 2 || !bond.get(0)->isNumber() ||
+        !bond.get(1)->isNumber()) return false;
+
+    packed.push_back(bond.getU32(0));
+    packed.push_back(bond.getU32(1));
+  }
+
+  this->bonds.swap(packed);
+
+  return true;
+}
+
+
+Viewer::Frame::Frame(const JSON::Value &frame) {
+  // Usually a list of [x, y, z] atom positions
+  bool packed = frame.isList();
+  if (packed) positions.reserve(frame.size() * 3);
+
+  for (unsigned i = 0; packed && i < frame.size(); i++) {
+    auto &pos = *frame.get(i);
+
+    if (!pos.isList() || pos.size() != 3) packed = false;
+    else for (unsigned j = 0; j < 3 && packed; j++)
+           if (pos.get(j)->isNumber())
+             positions.push_back(pos.getNumber(j));
+           else packed = false;
+  }
+
+  if (!packed) {
+    positions.clear();
+    positions.shrink_to_fit();
+    if (!frame.isList() || frame.size()) other = frame.copy(true);
+  }
+}
+
+
+uint64_t Viewer::Frame::getBytes() const {
+  return positions.size() * sizeof(float) + jsonBytes(other);
+}
+
+
+JSON::ValuePtr Viewer::Frame::toJSON() const {
+  if (other.isSet()) return other;
+
+  JSON::ValuePtr frame = new JSON::List;
+
+  for (unsigned i = 0; i < positions.size(); i += 3) {
+    JSON::ValuePtr pos = new JSON::List;
+    for (unsigned j = 0; j < 3; j++) pos->append(toDouble(positions[i + j]));
+    frame->append(pos);
+  }
+
+  return frame;
+}
+
+
+bool Viewer::Frame::operator==(const Frame &o) const {
+  if (other.isSet() || o.other.isSet())
+    return other.isSet() && o.other.isSet() && *other == *o.other;
+
+  return positions == o.positions;
+}
+
+
+void Viewer::setTopology(const SmartPointer<Topology> &topology) {
+  this->topology = topology;
+  frames.clear();
+  bytes = topology->getBytes();
+}
+
+
+JSON::ValuePtr Viewer::getTopologyJSON() const {
+  return topology.isNull() ? 0 : topology->toJSON();
+}
+
+
+void Viewer::addFrame(const SmartPointer<Frame> &frame) {
+  frames.push_back(frame);
+  bytes += frame->getBytes();
+}
+
+
+JSON::ValuePtr Viewer::getFrameJSON(unsigned i) const {
+  return frames.at(i)->toJSON();
+}
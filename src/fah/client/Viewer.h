@@ -0,0 +1,115 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/json/Value.h>
+
+#include <vector>
+#include <cstdint>
+
+
+namespace FAH {
+  namespace Client {
+    /// Visualization data held as packed arrays instead of JSON trees.
+    /// JSON is only built when a remote asks for it.
+    class Viewer : public cb::RefCounted {
+    public:
+      class Topology : public cb::RefCounted {
+        const uint64_t id; // Unique per process
+
+        // Atoms are tuples, each field is either all numbers or all strings
+        unsigned atomCount = 0;
+        std::vector<bool>        stringField;
+        std::vector<float>       atomNumbers;
+        std::vector<uint32_t>    atomStrings; // Indices in to strings
+        std::vector<std::string> strings;
+
+        std::vector<uint32_t> bonds; // Pairs of atom indices
+
+        cb::JSON::ValuePtr other; // Anything not packed above
+        uint64_t bytes = 0;
+
+      public:
+        Topology(const cb::JSON::Value &topology);
+
+        uint64_t getID() const {return id;}
+        uint64_t getBytes() const {return bytes;}
+        unsigned getAtomCount() const {return atomCount;}
+
+        /// @return the atoms for level of detail @param lod, "ca" for C-alpha
+        /// or "heavy" for non-hydrogen.  Empty means all atoms.
+        std::vector<uint32_t> select(const std::string &lod) const;
+
+        cb::JSON::ValuePtr toJSON(const std::vector<uint32_t> &atoms = {}) const;
+
+      protected:
+        bool packAtoms(const cb::JSON::Value &atoms);
+        bool packBonds(const cb::JSON::Value &bonds);
+      };
+
+
+      class Frame : public cb::RefCounted {
+        std::vector<float> positions; // x, y, z per atom
+        cb::JSON::ValuePtr other;     // Frame in an unknown format
+
+      public:
+        Frame(const cb::JSON::Value &frame);
+
+        bool empty() const {return positions.empty() && other.isNull();}
+        const std::vector<float> &getPositions() const {return positions;}
+        uint64_t getBytes() const;
+        cb::JSON::ValuePtr toJSON() const;
+
+        bool operator==(const Frame &o) const;
+      };
+
+    private:
+      cb::SmartPointer<Topology> topology;
+      std::vector<cb::SmartPointer<Frame>> frames;
+      uint64_t bytes = 0;
+
+    public:
+      bool hasTopology() const {return topology.isSet();}
+      const Topology &getTopology() const {return *topology;}
+      void setTopology(const cb::SmartPointer<Topology> &topology);
+      cb::JSON::ValuePtr getTopologyJSON() const;
+
+      unsigned getFrameCount() const {return frames.size();}
+      const Frame &getFrame(unsigned i) const {return *frames.at(i);}
+      void addFrame(const cb::SmartPointer<Frame> &frame);
+      cb::JSON::ValuePtr getFrameJSON(unsigned i) const;
+
+      /// Decoded size of all topology and frame data
+      uint64_t getBytes() const {return bytes;}
+
+      /// Output float32 values as short decimals instead of their exact double
+      static double toDouble(float x);
+    };
+  }
+}
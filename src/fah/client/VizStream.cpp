@@ -0,0 +1,162 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "VizStream.h"
+
+#include <cbang/Exception.h>
+#include <cbang/json/JSON.h>
+#include <cbang/time/Timer.h>
+
+#include <cmath>
+
+using namespace FAH::Client;
+using namespace cb;
+using namespace std;
+
+
+VizStream::VizStream(const JSON::Value &msg) :
+  lod(msg.getString("lod", "all")), delta(msg.getBoolean("delta", false)),
+  fps(msg.getNumber("fps", 0)) {
+
+  if (msg.has("precision")) {
+    unsigned precision = msg.getU32("precision");
+    if (6 < precision) THROW("Viz precision must be 0 to 6 digits");
+    scale = pow(10, precision);
+  }
+
+  if (delta && !scale) THROW("Viz delta encoding requires precision");
+  if (fps < 0) THROW("Viz fps cannot be negative");
+}
+
+
+bool VizStream::isRequested(const JSON::Value &msg) {
+  return msg.has("lod") || msg.has("precision") || msg.has("delta") ||
+    msg.has("fps");
+}
+
+
+double VizStream::getDelay() const {
+  if (!fps || !lastFrame) return 0;
+  double delay = lastFrame + 1 / fps - Timer::now();
+  return delay < 0 ? 0 : delay;
+}
+
+
+void VizStream::setTopology(const Viewer::Topology &topology) {
+  // Not the address, a reloaded topology may reuse it
+  if (topologyID == topology.getID()) return;
+
+  topologyID = topology.getID();
+  atoms = topology.select(lod);
+  previous.clear();
+}
+
+
+JSON::ValuePtr VizStream::encodeTopology(const Viewer::Topology &topology) {
+  setTopology(topology);
+  previous.clear(); // Topology is resent, so restart deltas too
+  return topology.toJSON(atoms);
+}
+
+
+JSON::ValuePtr VizStream::encodeFrame(const Viewer::Frame &frame) {
+  lastFrame = Timer::now();
+
+  auto &positions = frame.getPositions();
+  if (positions.empty()) return frame.toJSON(); // Unknown format
+
+  unsigned count = atoms.empty() ? positions.size() / 3 : atoms.size();
+  JSON::ValuePtr list = new JSON::List;
+
+  // Lower the scale for this frame if a coordinate would not fit in int32
+  double frameScale = scale;
+  if (scale) {
+    float maxAbs = 0;
+    bool finite = true;
+
+    for (unsigned k = 0; k < count && finite; k++) {
+      unsigned i = (atoms.empty() ? k : atoms[k]) * 3;
+      if (positions.size() <= i + 2) break;
+
+      for (unsigned j = 0; j < 3; j++) {
+        float x = positions[i + j];
+        if (!isfinite(x)) finite = false;
+        else if (maxAbs < fabs(x)) maxAbs = fabs(x);
+      }
+    }
+
+    while (1 < frameScale && INT32_MAX < maxAbs * frameScale) frameScale /= 10;
+    if (!finite || INT32_MAX < maxAbs * frameScale) frameScale = 0;
+  }
+
+  if (!frameScale) {
+    previous.clear(); // Deltas restart with the next quantized frame
+
+    for (unsigned k = 0; k < count; k++) {
+      unsigned i = (atoms.empty() ? k : atoms[k]) * 3;
+      if (positions.size() <= i + 2) break;
+
+      JSON::ValuePtr pos = new JSON::List;
+      for (unsigned j = 0; j < 3; j++)
+        pos->append(Viewer::toDouble(positions[i + j]));
+      list->append(pos);
+    }
+
+    return list;
+  }
+
+  // Flat list of x, y, z integers, the difference to the last frame if delta
+  vector<int32_t> quantized;
+  quantized.reserve(count * 3);
+
+  for (unsigned k = 0; k < count; k++) {
+    unsigned i = (atoms.empty() ? k : atoms[k]) * 3;
+    if (positions.size() <= i + 2) break;
+
+    for (unsigned j = 0; j < 3; j++)
+      quantized.push_back(lround(positions[i + j] * frameScale));
+  }
+
+  bool isDelta = delta && previousScale == frameScale &&
+    previous.size() == quantized.size();
+
+  for (unsigned i = 0; i < quantized.size(); i++)
+    list->append((int64_t)quantized[i] - (isDelta ? previous[i] : 0));
+
+  if (delta) {
+    previous.swap(quantized);
+    previousScale = frameScale;
+  }
+
+  JSON::ValuePtr result = new JSON::Dict;
+  result->insert("scale", frameScale);
+  result->insertBoolean("delta", isDelta);
+  result->insert("positions", list);
+
+  return result;
+}
@@ -0,0 +1,63 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Viewer.h"
+
+
+namespace FAH {
+  namespace Client {
+    /// Per remote viz encoding: level of detail, quantized and delta encoded
+    /// coordinates and a frame rate limit.
+    class VizStream : public cb::RefCounted {
+      std::string lod;
+      double   scale = 0;  // Quantization factor, 0 for plain floats
+      bool     delta = false;
+      double   fps   = 0;
+
+      uint64_t topologyID = 0;
+      std::vector<uint32_t> atoms;    // Selected atoms, empty for all
+      std::vector<int32_t>  previous; // Last quantized frame sent
+      double previousScale = 0;
+      double lastFrame = 0;
+
+    public:
+      VizStream(const cb::JSON::Value &msg);
+
+      static bool isRequested(const cb::JSON::Value &msg);
+
+      /// @return seconds until the next frame may be sent
+      double getDelay() const;
+
+      void setTopology(const Viewer::Topology &topology);
+      cb::JSON::ValuePtr encodeTopology(const Viewer::Topology &topology);
+      cb::JSON::ValuePtr encodeFrame(const Viewer::Frame &frame);
+    };
+  }
+}
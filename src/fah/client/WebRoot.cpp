@@ -0,0 +1,182 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "WebRoot.h"
+
+#include <cbang/String.h>
+#include <cbang/log/Logger.h>
+#include <cbang/openssl/Digest.h>
+#include <cbang/os/SystemUtilities.h>
+
+#include <cctype>
+
+using namespace FAH::Client;
+using namespace cb;
+using namespace std;
+
+
+namespace {
+  const char *contentTypes[][2] = {
+    {"html",  "text/html; charset=utf-8"},
+    {"js",    "text/javascript; charset=utf-8"},
+    {"mjs",   "text/javascript; charset=utf-8"},
+    {"css",   "text/css; charset=utf-8"},
+    {"json",  "application/json"},
+    {"map",   "application/json"},
+    {"txt",   "text/plain; charset=utf-8"},
+    {"svg",   "image/svg+xml"},
+    {"png",   "image/png"},
+    {"jpg",   "image/jpeg"},
+    {"ico",   "image/x-icon"},
+    {"woff",  "font/woff"},
+    {"woff2", "font/woff2"},
+    {"wasm",  "application/wasm"},
+    {0, 0}
+  };
+
+  const char *encodings[][2] = {{"br", ".br"}, {"gzip", ".gz"}, {0, 0}};
+}
+
+
+WebRoot::WebRoot(const string &root) : root(root) {}
+
+
+bool WebRoot::handle(HTTP::Request &req) {
+  string path = req.getURI().getPath();
+
+  // Refuse anything which could escape the web-root
+  if (path.empty() || path[0] != '/' || path.find("..") != string::npos ||
+      path.find('\\') != string::npos || path.find('\0') != string::npos)
+    THROWX("Invalid path", HTTP_BAD_REQUEST);
+
+  if (path.back() == '/') path += "index.html";
+
+  // Single page app, unknown paths get the index
+  string filename = root + path;
+  if (!SystemUtilities::exists(filename) ||
+      SystemUtilities::isDirectory(filename)) {
+    path = "/index.html";
+    filename = root + path;
+  }
+
+  // Prefer a precompressed variant the client accepts
+  string accept = req.inHas("Accept-Encoding") ?
+    req.inGet("Accept-Encoding") : "";
+  const file_t *file = 0;
+
+  for (unsigned i = 0; encodings[i][0] && !file; i++)
+    if (accepts(accept, encodings[i][0]) &&
+        (file = load(filename + encodings[i][1])))
+      req.outSet("Content-Encoding", encodings[i][0]);
+
+  if (!file && !(file = load(filename))) return false;
+
+  req.outSet("Vary", "Accept-Encoding");
+  req.outSet("ETag", file->etag);
+  req.outSet("Cache-Control", isHashed(path) ?
+             "public, max-age=31536000, immutable" : "no-cache");
+
+  if (req.inHas("If-None-Match") &&
+      req.inGet("If-None-Match").find(file->etag) != string::npos) {
+    req.reply(HTTP_NOT_MODIFIED);
+    return true;
+  }
+
+  req.setContentType(getContentType(path));
+  req.reply(file->data);
+
+  return true;
+}
+
+
+const WebRoot::file_t *WebRoot::load(const string &path) {
+  if (!SystemUtilities::exists(path)) {
+    cache.erase(path);
+    return 0;
+  }
+
+  // Reload when the file changes on disk
+  uint64_t modified = SystemUtilities::getModificationTime(path);
+  auto it = cache.find(path);
+  if (it != cache.end() && it->second.modified == modified) return &it->second;
+
+  LOG_DEBUG(4, "Loading " << path);
+
+  file_t &file = cache[path];
+  file.modified = modified;
+  file.data     = SystemUtilities::read(path);
+  file.etag     = "\"" + Digest::urlBase64(file.data, "sha256") + "\"";
+
+  return &file;
+}
+
+
+bool WebRoot::accepts(const string &header, const string &enc) {
+  vector<string> tokens;
+  String::tokenize(header, tokens, ",");
+
+  for (auto &token: tokens) {
+    vector<string> parts;
+    String::tokenize(token, parts, ";");
+
+    if (parts.empty() || String::trim(parts[0]) != enc) continue;
+    if (1 < parts.size() && String::trim(parts[1]) == "q=0") return false;
+
+    return true;
+  }
+
+  return false;
+}
+
+
+bool WebRoot::isHashed(const string &path) {
+  // Bundlers name assets like "index-Bq3x9Fa1.js" or "app.3f9a2c1e.css"
+  size_t ext = path.rfind('.');
+  if (ext == string::npos) return false;
+
+  size_t start = path.find_last_of("-./", ext - 1);
+  if (start == string::npos || path[start] == '/' || ext - start - 1 < 8)
+    return false;
+
+  bool digit = false;
+  for (size_t i = start + 1; i < ext; i++)
+    if (isdigit(path[i])) digit = true;
+    else if (!isalpha(path[i]) && path[i] != '_') return false;
+
+  return digit;
+}
+
+
+const char *WebRoot::getContentType(const string &path) {
+  string ext = String::toLower(SystemUtilities::extension(path));
+
+  for (unsigned i = 0; contentTypes[i][0]; i++)
+    if (ext == contentTypes[i][0]) return contentTypes[i][1];
+
+  return "application/octet-stream";
+}
@@ -0,0 +1,62 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/http/Request.h>
+
+#include <map>
+
+
+namespace FAH {
+  namespace Client {
+    /// Serves the web-root from memory, preferring precompressed variants
+    class WebRoot {
+      const std::string root;
+
+      struct file_t {
+        uint64_t    modified = 0;
+        std::string data;
+        std::string etag;
+      };
+
+      std::map<std::string, file_t> cache;
+
+    public:
+      WebRoot(const std::string &root);
+
+      bool handle(cb::HTTP::Request &req);
+
+    protected:
+      const file_t *load(const std::string &path);
+      static bool accepts(const std::string &header, const std::string &enc);
+      static bool isHashed(const std::string &path);
+      static const char *getContentType(const std::string &path);
+    };
+  }
+}
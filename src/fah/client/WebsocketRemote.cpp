@@ -28,6 +28,8 @@
 
 #include "WebsocketRemote.h"
 #include "App.h"
+#include "CBORWriter.h"
+#include "CBORReader.h"
 
 #include <cbang/http/Conn.h>
 
@@ -41,9 +43,22 @@ WebsocketRemote::WebsocketRemote(App &app) : Remote(app) {
 }
 
 
+void WebsocketRemote::setEncoding(const string &encoding) {
+  if (encoding == "cbor") cbor = true;
+  else if (encoding != "json")
+    THROWX("Unsupported encoding '" << encoding << "'", HTTP_BAD_REQUEST);
+}
+
+
 void WebsocketRemote::send(const cb::JSON::ValuePtr &msg) {
   pingEvent->add(15);
-  if (isActive()) WS::JSONWebsocket::send(*msg);
+  if (!isActive()) return;
+
+  if (cbor) {
+    string data = CBORWriter::encode(*msg);
+    writeFrame(WS_OP_BINARY, true, data.data(), data.size());
+
+  } else WS::JSONWebsocket::send(*msg);
 }
 
 
@@ -53,6 +68,14 @@ void WebsocketRemote::close() {
 }
 
 
+void WebsocketRemote::onMessage(const char *data, uint64_t length) {
+  // CBOR remotes may still send commands as JSON text frames
+  if (cbor && wsMsgType == WS_OP_BINARY)
+    onMessage(CBORReader::parse(data, length));
+  else WS::JSONWebsocket::onMessage(data, length);
+}
+
+
 void WebsocketRemote::onOpen() {
   name      = getConnection()->getPeerAddr().toString(false);
   pingEvent = getApp().getEventBase().newEvent([this] {sendPing();}, 0);
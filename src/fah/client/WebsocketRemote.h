@@ -38,10 +38,13 @@ namespace FAH {
     class WebsocketRemote : public Remote, public cb::WS::JSONWebsocket {
       std::string name = "unconnected";
       cb::SmartPointer<cb::Event::Event> pingEvent;
+      bool cbor = false;
 
     public:
       WebsocketRemote(App &app);
 
+      void setEncoding(const std::string &encoding);
+
       // From Remote
       std::string getName() const override {return name;}
       void send(const cb::JSON::ValuePtr &msg) override;
@@ -49,6 +52,7 @@ namespace FAH {
 
       // From cb::WS::JSONWebsocket
       using cb::WS::JSONWebsocket::send;
+      void onMessage(const char *data, uint64_t length) override;
       void onMessage(const cb::JSON::ValuePtr &msg) override
         {Remote::onMessage(msg);}
 
@@ -0,0 +1,114 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "WorkerThread.h"
+
+#include <cbang/Catch.h>
+#include <cbang/thread/SmartLock.h>
+
+using namespace FAH::Client;
+using namespace cb;
+using namespace std;
+
+
+WorkerThread::WorkerThread(Event::Base &base) :
+  event(base.newEvent([this] {complete();}, 0)) {}
+
+
+WorkerThread::~WorkerThread() {TRY_CATCH_ERROR(shutdown());}
+
+
+void WorkerThread::submit(work_t work, done_t done) {
+  SmartLock lock(this);
+
+  pending.push_back(job_t{work, done, ""});
+  if (!isRunning()) start();
+  signal();
+}
+
+
+void WorkerThread::shutdown(bool finish) {
+  if (!isRunning()) return;
+
+  {
+    SmartLock lock(this);
+    this->finish = finish;
+  }
+
+  stop();
+  {
+    SmartLock lock(this);
+    signal();
+  }
+  join();
+}
+
+
+void WorkerThread::complete() {
+  list<job_t> jobs;
+  {
+    SmartLock lock(this);
+    jobs.swap(completed);
+  }
+
+  for (auto &job: jobs)
+    TRY_CATCH_ERROR(job.done(job.error));
+}
+
+
+void WorkerThread::run() {
+  Condition::lock();
+
+  while (true) {
+    if (pending.empty()) {
+      if (shouldShutdown()) break;
+      wait();
+      continue;
+    }
+
+    if (shouldShutdown() && !finish) break;
+
+    job_t job = pending.front();
+    pending.pop_front();
+
+    Condition::unlock();
+    try {
+      job.work();
+    } catch (const Exception &e) {
+      job.error = e.getMessage();
+    } catch (const std::exception &e) {
+      job.error = e.what();
+    }
+    Condition::lock();
+
+    completed.push_back(job);
+    event->activate();
+  }
+
+  Condition::unlock();
+}
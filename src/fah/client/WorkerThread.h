@@ -0,0 +1,77 @@
+/******************************************************************************\
+
+                  This file is part of the Folding@home Client.
+
+          The fah-client runs Folding@home protein folding simulations.
+                    Copyright (c) 2001-2026, foldingathome.org
+                               All rights reserved.
+
+       This program is free software; you can redistribute it and/or modify
+       it under the terms of the GNU General Public License as published by
+        the Free Software Foundation; either version 3 of the License, or
+                       (at your option) any later version.
+
+         This program is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+          MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+                   GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License along
+     with this program; if not, write to the Free Software Foundation, Inc.,
+           51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/thread/Thread.h>
+#include <cbang/thread/Condition.h>
+#include <cbang/event/Base.h>
+#include <cbang/event/Event.h>
+
+#include <functional>
+#include <list>
+
+
+namespace FAH {
+  namespace Client {
+    /// Runs jobs off the event loop then calls their completion callback on
+    /// the event loop.
+    class WorkerThread : public cb::Thread, public cb::Condition {
+    public:
+      typedef std::function<void ()> work_t;
+      typedef std::function<void (const std::string &error)> done_t;
+
+    private:
+      struct job_t {
+        work_t work;
+        done_t done;
+        std::string error;
+      };
+
+      std::list<job_t> pending;
+      std::list<job_t> completed;
+      cb::Event::EventPtr event;
+      bool finish = false;
+
+    public:
+      WorkerThread(cb::Event::Base &base);
+      ~WorkerThread();
+
+      /// @param done is called with an empty string if @param work succeeded
+      void submit(work_t work, done_t done);
+      /// @param finish runs pending jobs first, their callbacks are not called
+      void shutdown(bool finish = false);
+
+    protected:
+      void complete();
+
+      // From cb::Thread
+      void run() override;
+    };
+  }
+}
@@ -0,0 +1,23 @@
+// Encodes a JSON value read from stdin as CBOR with FAH::Client::CBORWriter,
+// prints the encoding as hex, then decodes it with FAH::Client::CBORReader
+// and prints the result as compact JSON for the test harness to diff.
+
+#include <fah/client/CBORWriter.h>
+#include <fah/client/CBORReader.h>
+
+#include <cbang/String.h>
+#include <cbang/json/Reader.h>
+
+#include <iostream>
+
+
+int main(int argc, char *argv[]) {
+  auto value   = cb::JSON::Reader(std::cin).parse();
+  auto encoded = FAH::Client::CBORWriter::encode(*value);
+
+  std::cout << cb::String::hexEncode(encoded) << '\n';
+  std::cout << FAH::Client::CBORReader::parse(encoded)->toString(0, true)
+            << '\n';
+
+  return 0;
+}
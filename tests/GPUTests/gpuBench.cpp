@@ -0,0 +1,107 @@
+// Adds N GPUs to the inventory, read as "N P" from stdin, enables every
+// other one in the default group and reads the group's supported GPUs P
+// times, as Group::update() does, both through the cached set and by
+// checking every GPU.  Then disables one GPU, enables a new one and adds it
+// to the inventory to show the cached set follows config and inventory
+// changes.  Reports agreement to stdout and timings to the log.
+
+#include <fah/client/App.h>
+#include <fah/client/Config.h>
+#include <fah/client/Groups.h>
+#include <fah/client/Group.h>
+#include <fah/client/GPUResource.h>
+#include <fah/client/GPUResources.h>
+
+#include <cbang/ApplicationMain.h>
+#include <cbang/SmartPointer.h>
+#include <cbang/String.h>
+#include <cbang/json/Dict.h>
+#include <cbang/log/Logger.h>
+#include <cbang/time/Timer.h>
+
+#include <iostream>
+
+
+namespace FAH {
+  namespace Client {
+    class GPUBench : public App {
+    public:
+      void addGPU(const std::string &id) {
+        cb::SmartPointer<GPUResource> gpu = new GPUResource(id);
+        gpu->insertBoolean("supported", true);
+        gpu->insert("cuda", new cb::JSON::Dict);
+        getGPUs().insert(id, gpu);
+      }
+
+
+      void run() override {
+        setup();
+
+        unsigned count = 0, passes = 0;
+        std::cin >> count >> passes;
+
+        auto &config = getGroups()->getGroup("").getConfig();
+        cb::JSON::ValuePtr enabled = new cb::JSON::Dict;
+
+        for (unsigned i = 0; i < count; i++) {
+          std::string id = "gpu:" + cb::String(i);
+          addGPU(id);
+
+          cb::JSON::ValuePtr gpu = new cb::JSON::Dict;
+          gpu->insertBoolean("enabled", !(i & 1));
+          enabled->insert(id, gpu);
+        }
+
+        cb::JSON::Dict changes;
+        changes.insert("gpus", enabled);
+        config.configure(changes);
+
+        // Cached
+        uint64_t cached = 0;
+        double start = cb::Timer::now();
+        for (unsigned pass = 0; pass < passes; pass++)
+          cached += config.getGPUs().size();
+        double cachedTime = cb::Timer::now() - start;
+
+        // Checking every GPU
+        uint64_t checked = 0;
+        start = cb::Timer::now();
+        for (unsigned pass = 0; pass < passes; pass++) {
+          std::set<std::string> gpus;
+
+          for (auto &v: getGPUs()) {
+            auto &gpu = *v.cast<GPUResource>();
+            if (gpu.isSupported(config)) gpus.insert(gpu.getID());
+          }
+
+          checked += gpus.size();
+        }
+        double checkedTime = cb::Timer::now() - start;
+
+        std::cout << "supported=" << config.getGPUs().size() << " agree="
+                  << (cached == checked ? "true" : "false") << '\n';
+        LOG_INFO(1, "Supported GPUs: cached " << cachedTime << "s, checked "
+                 << checkedTime << 's');
+
+        // Config change
+        config.disableGPU("gpu:0");
+        std::cout << "disabled=" << config.getGPUs().size() << '\n';
+
+        // Inventory change
+        std::string id = "gpu:" + cb::String(count);
+        cb::JSON::ValuePtr gpu = new cb::JSON::Dict;
+        gpu->insertBoolean("enabled", true);
+        config.get("gpus")->insert(id, gpu);
+        std::cout << "enabled=" << config.getGPUs().size() << '\n';
+
+        addGPU(id);
+        std::cout << "added=" << config.getGPUs().size() << '\n';
+      }
+    };
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  return cb::doApplication<FAH::Client::GPUBench>(argc, argv);
+}
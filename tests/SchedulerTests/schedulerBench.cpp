@@ -0,0 +1,195 @@
+// Loads N units spread over G resource groups, read as "N G" from stdin,
+// then looks every unit up by ID and walks each group's units five times,
+// as Group::update() does, using both the indexes and the linear scans
+// they replaced.  Then removes an ID-less unit and every eighth unit and
+// checks again.  Reports agreement to stdout and timings to the log.
+
+#include <fah/client/App.h>
+#include <fah/client/Units.h>
+#include <fah/client/Groups.h>
+#include <fah/client/Group.h>
+#include <fah/client/Unit.h>
+
+#include <cbang/ApplicationMain.h>
+#include <cbang/SmartPointer.h>
+#include <cbang/String.h>
+#include <cbang/json/Dict.h>
+#include <cbang/log/Logger.h>
+#include <cbang/time/Timer.h>
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <vector>
+
+
+namespace FAH {
+  namespace Client {
+    class SchedulerBench : public App {
+    public:
+      // Checks every index position against a linear scan
+      bool positionsAgree() {
+        auto &units = *getUnits();
+
+        for (unsigned i = 0; i < units.size(); i++) {
+          auto unit = units.getUnit(i);
+          if (units.getUnitIndex(unit.get()) != (int)i) return false;
+          if (!unit->getID().empty() &&
+              units.getUnitIndex(unit->getID()) != (int)i) return false;
+        }
+
+        return true;
+      }
+
+
+      // Checks each group's units against a filtered linear scan
+      bool groupsAgree() {
+        auto &units  = *getUnits();
+        auto &groups = *getGroups();
+
+        for (auto &name: groups.keys()) {
+          auto &list = groups.getGroup(name).units();
+          std::set<Unit *> indexed(list.begin(), list.end());
+          std::set<Unit *> filtered;
+
+          for (unsigned i = 0; i < units.size(); i++)
+            if (units.getUnit(i)->getGroup().getName() == name)
+              filtered.insert(units.getUnit(i).get());
+
+          if (indexed.size() != list.size() || indexed != filtered)
+            return false;
+        }
+
+        return true;
+      }
+
+
+      cb::SmartPointer<Unit> load(const std::string &id, unsigned number,
+                                  const std::string &group) {
+        cb::JSON::ValuePtr state = new cb::JSON::Dict;
+        if (!id.empty()) state->insert("id", id);
+        state->insert("number", number);
+        state->insert("group",  group);
+        state->insert("state",  "DOWNLOAD");
+
+        cb::JSON::ValuePtr blob = new cb::JSON::Dict;
+        blob->insert("data",  new cb::JSON::Dict);
+        blob->insert("state", state);
+
+        cb::SmartPointer<Unit> unit = new Unit(*this, blob);
+        getUnits()->add(unit);
+        return unit;
+      }
+
+
+      void run() override {
+        setup();
+
+        unsigned count = 0, groupCount = 0;
+        std::cin >> count >> groupCount;
+
+        auto &units  = *getUnits();
+        auto &groups = *getGroups();
+
+        for (unsigned i = 0; i < groupCount; i++)
+          groups.getGroup("g" + cb::String(i));
+
+        for (unsigned i = 0; i < count; i++)
+          load("unit" + cb::String(i), i, "g" + cb::String(i % groupCount));
+
+        // Every loaded unit must be indexed and in exactly one group
+        uint64_t grouped = 0;
+        for (auto &name: groups.keys())
+          grouped += groups.getGroup(name).units().size();
+
+        bool loaded = units.size() == count && grouped == count;
+        std::cout << "units="  << units.size() << " agree="
+                  << (loaded ? "true" : "false") << '\n';
+        std::cout << "groups=" << groups.size() - 1 << '\n';
+
+        // Lookups by ID
+        std::vector<int> found;
+        double start = cb::Timer::now();
+        for (unsigned i = 0; i < count; i++)
+          found.push_back(units.getUnitIndex("unit" + cb::String(i)));
+        double indexed = cb::Timer::now() - start;
+
+        std::vector<int> scanned;
+        start = cb::Timer::now();
+        for (unsigned i = 0; i < count; i++) {
+          std::string id = "unit" + cb::String(i);
+          int index = -1;
+          for (unsigned j = 0; j < units.size(); j++)
+            if (units.getUnit(j)->getID() == id) {index = j; break;}
+          scanned.push_back(index);
+        }
+        double linear = cb::Timer::now() - start;
+
+        bool agree = found == scanned && positionsAgree();
+        std::cout << "lookups=" << count << " agree="
+                  << (agree ? "true" : "false") << '\n';
+        LOG_INFO(1, "ID lookups: indexed " << indexed << "s, linear "
+                 << linear << 's');
+
+        // Group unit walks, both read every unit they visit
+        const unsigned passes = 5;
+        uint64_t total = 0, filtered = 0, states = 0, filteredStates = 0;
+        start = cb::Timer::now();
+        for (auto &name: groups.keys())
+          for (unsigned pass = 0; pass < passes; pass++)
+            for (auto unit: groups.getGroup(name).units()) {
+              total++;
+              states += (unsigned)unit->getState();
+            }
+        indexed = cb::Timer::now() - start;
+
+        start = cb::Timer::now();
+        for (auto &name: groups.keys())
+          for (unsigned pass = 0; pass < passes; pass++)
+            for (unsigned j = 0; j < units.size(); j++) {
+              auto unit = units.getUnit(j);
+              if (unit->getGroup().getName() != name) continue;
+              filtered++;
+              filteredStates += (unsigned)unit->getState();
+            }
+        linear = cb::Timer::now() - start;
+
+        agree = total == filtered && states == filteredStates && groupsAgree();
+        std::cout << "group_units=" << total << " agree="
+                  << (agree ? "true" : "false") << '\n';
+        LOG_INFO(1, "Group walks: indexed " << indexed << "s, filtered "
+                 << linear << 's');
+
+        // A unit without an ID is loaded as DONE and must still be removable
+        auto idless = load("", count, "g0");
+        bool done = idless->getState() == UnitState::UNIT_DONE;
+        units.removeUnit(idless.get());
+
+        // Remove every eighth unit, keeping them alive as a caller might
+        std::vector<cb::SmartPointer<Unit> > removed;
+        for (unsigned i = 0; i < count; i += 8) {
+          removed.push_back(units.getUnit("unit" + cb::String(i)));
+          units.removeUnit("unit" + cb::String(i));
+        }
+
+        agree = done && units.getUnitIndex(idless.get()) == -1 &&
+          positionsAgree() && groupsAgree();
+
+        for (auto &unit: removed) {
+          auto &list = unit->getGroup().units();
+          agree = agree && units.getUnitIndex(unit->getID()) == -1 &&
+            std::find(list.begin(), list.end(), unit.get()) == list.end();
+        }
+
+        std::cout << "removed=" << removed.size() + 1 << " units="
+                  << units.size() << " agree="
+                  << (agree ? "true" : "false") << '\n';
+      }
+    };
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  return cb::doApplication<FAH::Client::SchedulerBench>(argc, argv);
+}